@@ -4,6 +4,7 @@
 #include <cmath>
 #include "ofxAbletonLink.h"
 #include "utilities.h"
+#include "frame_clock.h"
 #include "ofxAbletonLiveTrack.h"
 #include "ofxAbletonLive.h"
 
@@ -92,6 +93,16 @@ namespace ofxBenG {
             return status.beat - startBeat;
         }
 
+        frame_clock getFrameClock() {
+            ofxAbletonLink::Status status = link.update();
+            frame_clock clock;
+            clock.beat = status.beat - startBeat;
+            clock.phase = status.phase;
+            clock.tempo = link.tempo();
+            clock.microseconds = ofGetElapsedTimeMicros();
+            return clock;
+        }
+
         float getNextWholeBeat() {
             return ceil(getBeat());
         }
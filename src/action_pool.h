@@ -0,0 +1,108 @@
+#ifndef action_pool_h
+#define action_pool_h
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ofxBenG {
+
+    /*
+     * Size-class free lists for beat_action objects and their timing wheels' slots. Blocks
+     * are carved out of chunks and returned to their free list on delete, so once a show has
+     * warmed up, cueing and retiring actions no longer reaches the system allocator. Like
+     * the rest of the action tree, the pool is only used from the render thread.
+     */
+    class action_pool {
+    public:
+        static void *allocate(std::size_t size) {
+            int const sizeClass = sizeClassOf(size);
+            if (sizeClass < 0) {
+                heapAllocationCount()++;
+                return ::operator new(size);
+            }
+
+            block *&freeList = freeLists()[sizeClass];
+            if (freeList == nullptr)
+                grow(sizeClass);
+            block *b = freeList;
+            freeList = b->next;
+            return b;
+        }
+
+        static void release(void *p, std::size_t size) {
+            if (p == nullptr)
+                return;
+
+            int const sizeClass = sizeClassOf(size);
+            if (sizeClass < 0) {
+                ::operator delete(p);
+                return;
+            }
+
+            block *b = static_cast<block *>(p);
+            block *&freeList = freeLists()[sizeClass];
+            b->next = freeList;
+            freeList = b;
+        }
+
+        /* Number of times the pool has gone to the system allocator; flat across a frame means no heap churn. */
+        static std::size_t getHeapAllocations() {
+            return heapAllocationCount();
+        }
+
+        static std::size_t const smallestBlock = 64;
+        /* Up to 8 KB, which is a timing wheel's slots. */
+        static int const sizeClassCount = 8;
+        static int const blocksPerChunk = 64;
+        /* Chunks of the bigger classes hold fewer blocks, so no chunk is over 64 KB. */
+        static std::size_t const largestChunk = 64 * 1024;
+
+    private:
+        struct block {
+            block *next;
+        };
+
+        static int sizeClassOf(std::size_t size) {
+            std::size_t blockSize = smallestBlock;
+            for (int i = 0; i < sizeClassCount; i++, blockSize <<= 1) {
+                if (size <= blockSize)
+                    return i;
+            }
+            return -1;
+        }
+
+        static void grow(int sizeClass) {
+            std::size_t const blockSize = smallestBlock << sizeClass;
+            int const blockCount = (int) std::min<std::size_t>(blocksPerChunk, largestChunk / blockSize);
+            char *chunk = static_cast<char *>(::operator new(blockSize * blockCount));
+            heapAllocationCount()++;
+            chunks().push_back(chunk);
+            block *&freeList = freeLists()[sizeClass];
+            for (int i = blockCount - 1; i >= 0; i--) {
+                block *b = reinterpret_cast<block *>(chunk + i * blockSize);
+                b->next = freeList;
+                freeList = b;
+            }
+        }
+
+        static block **freeLists() {
+            static block *lists[sizeClassCount] = {};
+            return lists;
+        }
+
+        static std::vector<char *> &chunks() {
+            static std::vector<char *> allChunks;
+            return allChunks;
+        }
+
+        static std::size_t &heapAllocationCount() {
+            static std::size_t count = 0;
+            return count;
+        }
+    };
+
+} // ofxBenG
+
+#endif /* action_pool_h */
@@ -2,19 +2,160 @@
 #define ofxbengaudio_h
 
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <functional>
 #include <utility>
 #include "ofxMaxim.h"
 #include "property.h"
+#include "frame_clock.h"
+#include "spsc_queue.h"
+#include "voice_table.h"
+#include <thread>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace ofxBenG {
     typedef std::function<float()> MixFunction;
-    struct mix_t {
-        mix_t(MixFunction f) : f_ {std::move(f)} {}
-        MixFunction f_;
+    /* Renders the next frames samples of a voice into out. */
+    typedef std::function<void(float *out, int frames)> BlockMixFunction;
+
+    /* Anything the audio thread hands back through audio's retired queue, to be deleted on the cueing thread. */
+    struct audio_retirable {
+        virtual ~audio_retirable() {}
+    };
+
+    /*
+     * A voice the audio thread renders a block at a time into a contiguous buffer. A
+     * per-sample MixFunction still works, but costs a call per frame; a BlockMixFunction is
+     * called once per block.
+     */
+    struct mix_t : public audio_retirable {
+        mix_t(MixFunction f)
+                : render_ {[f](float *out, int frames) {
+                    for (int i = 0; i < frames; i++)
+                        out[i] = f();
+                }} {}
+        mix_t(BlockMixFunction render) : render_ {std::move(render)} {}
+        virtual ~mix_t() {}
+        BlockMixFunction render_;
+
+        void render(float *out, int frames) {
+            render_(out, frames);
+        }
+
         float operator()() {
-            return f_();
+            float sample;
+            render_(&sample, 1);
+            return sample;
+        }
+
+        /* Written by the audio thread when a cue starts or stops this mix. */
+        bool isPlaying() {
+            return state.load(std::memory_order_acquire) == PLAYING;
+        }
+
+        bool isStopped() {
+            return state.load(std::memory_order_acquire) == STOPPED;
+        }
+
+        enum {
+            IDLE, PLAYING, STOPPED
+        };
+        std::atomic<int> state = {IDLE};
+
+        /* Twice the number of queued cues naming this mix, plus one once audio::retire() has handed it over. */
+        std::atomic<int> cueReferences = {0};
+
+        /* Set while audio::remove() waits for the audio thread to drop this mix's queued cues. */
+        std::atomic<bool> isRemoved = {false};
+    };
+
+    /*
+     * Held by its owner and by the audio thread, which keeps using it after the owner lets go
+     * until it is finished with it. Whichever side lets go last frees it; the audio thread
+     * does so by handing it back through the retired queue.
+     */
+    struct audio_shared : public audio_retirable {
+        std::atomic<int> holders = {2};
+    };
+
+    /* Loops [startPercent, endPercent) of a sample on the audio thread, retriggering exactly when the playhead crosses the end. */
+    struct sample_loop : public audio_shared {
+        ofxMaxiSample *sample;
+        double startPercent;
+        double endPercent;
+        std::atomic<int> remaining;
+    };
+
+    /*
+     * Plays lengthSeconds of backward, starting at the mirror of forward's playhead, while
+     * forward is silenced and rewound by the same length; forward then takes over again.
+     * The audio thread moves both playheads and publishes state.
+     */
+    struct sample_reverse : public audio_shared {
+        enum {
+            WAITING, REVERSING, DONE
+        };
+
+        ofxMaxiSample *forward;
+        ofxMaxiSample *backward;
+        double lengthSeconds;
+        std::atomic<int> state;
+    };
+
+    /* A command for the audio thread, applied on the sample that corresponds to its target time. */
+    struct audio_cue {
+        enum type_t {
+            START_MIX, STOP_MIX, PLAY_SAMPLE, LOOP_SAMPLE, REVERSE_SAMPLE, RESUME_SAMPLE
+        };
+
+        static audio_cue startMix(mix_t *mix, float beat, const frame_clock &clock) {
+            return make(START_MIX, clock.microsecondsAtBeat(beat), mix, nullptr, nullptr);
+        }
+
+        static audio_cue stopMix(mix_t *mix, float beat, const frame_clock &clock) {
+            return make(STOP_MIX, clock.microsecondsAtBeat(beat), mix, nullptr, nullptr);
+        }
+
+        static audio_cue playSample(ofxMaxiSample *sample) {
+            return make(PLAY_SAMPLE, IMMEDIATELY, nullptr, sample, nullptr);
+        }
+
+        static audio_cue loopSample(sample_loop *loop) {
+            return make(LOOP_SAMPLE, IMMEDIATELY, nullptr, nullptr, loop);
+        }
+
+        /* The matching RESUME_SAMPLE is scheduled by the audio thread when this one lands. */
+        static audio_cue reverseSample(sample_reverse *reverse, uint64_t targetMicroseconds) {
+            audio_cue cue = make(REVERSE_SAMPLE, targetMicroseconds, nullptr, nullptr, nullptr);
+            cue.reverse = reverse;
+            return cue;
+        }
+
+        static audio_cue make(type_t type, uint64_t targetMicroseconds, mix_t *mix, ofxMaxiSample *sample, sample_loop *loop) {
+            audio_cue cue;
+            cue.type = type;
+            cue.targetMicroseconds = targetMicroseconds;
+            cue.mix = mix;
+            cue.sample = sample;
+            cue.loop = loop;
+            cue.reverse = nullptr;
+            return cue;
         }
+
+        static uint64_t const IMMEDIATELY = 0;
+
+        type_t type;
+        uint64_t targetMicroseconds;
+        uint64_t targetSample;
+        mix_t *mix;
+        ofxMaxiSample *sample;
+        sample_loop *loop;
+        sample_reverse *reverse;
     };
 
     class audio {
@@ -27,47 +168,194 @@ namespace ofxBenG {
         void operator=(audio const&) = delete;
 
         void playSample(ofxMaxiSample *sample) {
-            sample->setPosition(0);
-            if (!isSamplePlaying(sample))
-                samples.push_back(sample);
+            cue(audio_cue::playSample(sample));
         }
 
         void setSample(ofxMaxiSample *s) {
             playSample(s);
         }
 
+        /*
+         * Starts a mix through the cue queue; only the audio thread adds to the voice table, so
+         * the mix plays once its cue lands, cueLatencySamples after this call.
+         */
         void add(mix_t* mix) {
-            mixes.push_back(mix);
+            cue(audio_cue::make(audio_cue::START_MIX, audio_cue::IMMEDIATELY, mix, nullptr, nullptr));
         }
 
+        /*
+         * Stops a mix; once remove() returns the mix can be deleted. Call it from the thread
+         * that cues. The audio thread itself never waits.
+         *
+         * A START_MIX from add() may still be queued, so first the mix is marked removed and
+         * this waits until the audio thread has dropped every cue naming it, which it does on
+         * its next callback. If the stream isn't running, no callback is coming, so this
+         * drops those cues itself instead of waiting.
+         *
+         * Then the mix comes out of the voice table. If the audio thread is mid-callback it
+         * may still be calling the mix, so this spin-yields until that callback finishes,
+         * which is at most one buffer (about 12 ms). Clearing the slot and then reading the
+         * epoch here mirrors process() bumping the epoch and then reading slots. Both sides
+         * need a seq_cst fence between their write and their read, otherwise each can miss the
+         * other's write and the mix is freed mid-callback.
+         */
         void remove(mix_t* mix) {
-            mixes.erase(std::remove(mixes.begin(), mixes.end(), mix), mixes.end());
+            if (mix->cueReferences.load(std::memory_order_acquire) >= 2) {
+                mix->isRemoved.store(true, std::memory_order_seq_cst);
+                removalsPending.fetch_add(1, std::memory_order_seq_cst);
+                while (mix->cueReferences.load(std::memory_order_acquire) >= 2 && isStreamRunning())
+                    std::this_thread::yield();
+                if (mix->cueReferences.load(std::memory_order_acquire) >= 2)
+                    applyRemovedCuesWhileStopped();
+                removalsPending.fetch_sub(1, std::memory_order_relaxed);
+                mix->isRemoved.store(false, std::memory_order_relaxed);
+            }
+
+            if (mixes.remove(mix)) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                uint64_t const epoch = renderEpoch.load(std::memory_order_seq_cst);
+                if (epoch % 2 == 1) {
+                    while (renderEpoch.load(std::memory_order_seq_cst) == epoch && isStreamRunning())
+                        std::this_thread::yield();
+                }
+            }
         }
 
-        bool isSamplePlaying(ofxMaxiSample *sample) {
-            for (auto it : samples) {
-                if (it == sample) return true;
+        /* True from the stream's first callback until streamStopped(). */
+        bool isStreamRunning() {
+            return isRunning.load(std::memory_order_seq_cst);
+        }
+
+        /*
+         * Call once the sound stream has stopped, i.e. after its stop() or close() has
+         * returned, so remove() and retire() stop counting on callbacks that won't come. The
+         * next callback marks the stream running again.
+         */
+        void streamStopped() {
+            isRunning.store(false, std::memory_order_seq_cst);
+            callbackThread = std::thread::id();
+        }
+
+        /*
+         * Hands a cue to the audio thread; returns false if the queue is full, in which case
+         * the audio thread's hold on a loop or reverse it names is dropped. The queue is
+         * single-producer: the first thread to cue, retire or play a sample owns it, and debug
+         * builds assert that no other thread does until the audio stream restarts.
+         *
+         * An IMMEDIATELY cue is stamped with the time it is queued, so it gets the same
+         * cueLatencySamples as a timed cue and keeps its order with timed cues issued
+         * alongside it.
+         */
+        bool cue(audio_cue c) {
+            assertProducer();
+            deleteRetired();
+            if (c.targetMicroseconds == audio_cue::IMMEDIATELY)
+                c.targetMicroseconds = std::max<uint64_t>(microsecondsSource(), 1);
+            if (c.mix != nullptr)
+                c.mix->cueReferences.fetch_add(2, std::memory_order_relaxed);
+            bool const queued = cues.push(c);
+            if (!queued) {
+                if (c.mix != nullptr)
+                    c.mix->cueReferences.fetch_sub(2, std::memory_order_relaxed);
+                /* The audio thread will never see this loop or reverse, so its hold goes now. */
+                if (c.loop != nullptr)
+                    c.loop->holders.fetch_sub(1, std::memory_order_acq_rel);
+                if (c.reverse != nullptr)
+                    c.reverse->holders.fetch_sub(1, std::memory_order_acq_rel);
             }
-            return false;
+            return queued;
         }
 
-        float getMix() {
-            float master = 0;
-            for (auto& mix : mixes)
-                master += (*mix)();
+        /*
+         * Stops a cued mix at once and gives it to the audio thread, which hands it back for
+         * deletion once no queued cue names it. Later cue() calls delete what has come back.
+         * With the stream stopped nothing would hand it back, so it is removed and deleted
+         * here.
+         */
+        void retire(mix_t *mix) {
+            assertProducer();
+            deleteRetired();
+            if (!isStreamRunning()) {
+                remove(mix);
+                delete mix;
+                return;
+            }
+            /* The stop cue's reference and the retired mark go on together, so the audio thread can't see one without the other. */
+            mix->cueReferences.fetch_add(2 + RETIRED, std::memory_order_acq_rel);
+            if (!cues.push(audio_cue::make(audio_cue::STOP_MIX, audio_cue::IMMEDIATELY, mix, nullptr, nullptr))) {
+                if (mix->cueReferences.fetch_sub(2, std::memory_order_acq_rel) - 2 == RETIRED)
+                    delete mix;
+            }
+        }
 
-            std::vector<ofxMaxiSample*> finishedSamples;
-            for (ofxMaxiSample* sample : samples) {
-                master += sample->playOnce() * volume;
-                if (sample->isDone()) {
-                    finishedSamples.push_back(sample);
-                }
+        /*
+         * Lets go of a loop or reverse on behalf of its owner, e.g. a stutter deleted before its
+         * loop has run out. The audio thread plays it out and hands it back; if the audio
+         * thread has already finished with it, it is deleted here.
+         */
+        void retire(audio_shared *shared) {
+            assertProducer();
+            deleteRetired();
+            if (shared->holders.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete shared;
+        }
+
+        /* Deletes the mixes, loops and reverses the audio thread has finished with since the last call. */
+        void deleteRetired() {
+            audio_retirable *retiree;
+            while (retired.pop(retiree)) {
+                delete retiree;
             }
-            for (ofxMaxiSample* sample : finishedSamples) {
-                samples.erase(std::remove(samples.begin(), samples.end(), sample), samples.end());
+        }
+
+        /* What the audio thread is playing, so a sample only shows up once its playSample() cue has landed. */
+        bool isSamplePlaying(ofxMaxiSample *sample) {
+            return samples.contains(sample);
+        }
+
+        /*
+         * Renders one audio callback's worth of frames into an interleaved buffer. Each voice
+         * renders into its own contiguous block, blocks are summed with SIMD, and the block is
+         * split only where a cue lands.
+         */
+        void process(float *out, int frames, int channels) {
+            uint64_t const epoch = renderEpoch.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (std::this_thread::get_id() != callbackThread)
+                streamStarted(epoch);
+            beginBuffer();
+            int rendered = 0;
+            while (rendered < frames) {
+                if (sampleClock >= nextCueSample)
+                    applyDueCues();
+                int length = std::min(frames - rendered, (int) maxBlockFrames);
+                if (nextCueSample != UINT64_MAX)
+                    length = (int) std::min<uint64_t>(length, nextCueSample - sampleClock);
+                renderBlock(length);
+                float *destination = out + rendered * channels;
+                for (int i = 0; i < length; i++) {
+                    for (int c = 0; c < channels; c++) {
+                        destination[i * channels + c] = block[i];
+                    }
+                }
+                rendered += length;
             }
+            renderEpoch.fetch_add(1, std::memory_order_seq_cst);
+        }
 
-            return master;
+        /*
+         * Per-sample access for callers that have not moved to process(). It renders a
+         * bufferSize block through process() whenever the last one runs out, starting with the
+         * first call, and hands it out a sample at a time: its output runs up to a block ahead
+         * of the caller, and cues and voice changes land on block boundaries as seen from here.
+         * Don't mix it with process() on the same stream.
+         */
+        float getMix() {
+            if (monoPosition == bufferSize) {
+                process(monoBuffer, bufferSize, 1);
+                monoPosition = 0;
+            }
+            return monoBuffer[monoPosition++];
         }
 
         float getVolume() {
@@ -90,23 +378,363 @@ namespace ofxBenG {
             return bufferSize;
         }
 
+        /* Replaces the wall clock the audio thread maps cue times against, e.g. with a fake clock for offline renders. */
+        void setMicrosecondsSource(std::function<uint64_t()> source) {
+            microsecondsSource = source;
+            isAnchored = false;
+        }
+
+        /* Output sample that a wall-clock time lands on, including the fixed cue latency. */
+        uint64_t sampleAtMicroseconds(uint64_t microseconds) {
+            double const offset = ((double) microseconds - (double) anchorMicroseconds) * rate / 1e6;
+            double const sample = (double) anchorSample + offset + cueLatencySamples;
+            return (sample <= (double) sampleClock) ? sampleClock : (uint64_t) sample;
+        }
+
+        uint64_t getSampleClock() {
+            return sampleClock;
+        }
+
         static const int channels = 2;
         static const int bufferSize = 512;
         static const int rate = 44100;
+        /* Cues are rendered this many samples after their target time so a late render frame still lands them exactly. */
+        static const int cueLatencySamples = 2 * bufferSize;
+        static const int maxPendingCues = 256;
+        static const std::size_t maxLoops = 256;
+        static const int maxBlockFrames = 4096;
+        static const int maxVoices = 256;
+        static const int maxUnreturned = 1024;
+        static const int RETIRED = 1;
 
     private:
         audio() {
             ofxMaxiSettings::setup(rate, channels, bufferSize);
+            setMicrosecondsSource(ofGetElapsedTimeMicros);
+            loops.reserve(maxLoops);
         }
         audio(int rate, int channels, int bufferSize) {
             ofxMaxiSettings::setup(rate, channels, bufferSize);
+            setMicrosecondsSource(ofGetElapsedTimeMicros);
+            loops.reserve(maxLoops);
         }
         ~audio() {}
 
-        std::vector<mix_t*> mixes;
-        std::vector<ofxMaxiSample*> samples;
+        /*
+         * The first callback on a new thread, i.e. the stream has (re)started. The audio
+         * thread is the voice tables' only adder, so they are handed to it, and the cue
+         * queue's producer is re-latched by the next thread to cue. Debug builds still assert
+         * that no other callback is mid-render.
+         */
+        void streamStarted(uint64_t epoch) {
+            assert(epoch % 2 == 0);
+            callbackThread = std::this_thread::get_id();
+            mixes.relatchAdder();
+            samples.relatchAdder();
+            producer.store(std::thread::id(), std::memory_order_relaxed);
+            isRunning.store(true, std::memory_order_seq_cst);
+        }
+
+        /*
+         * Anchors sample time to wall-clock time. The anchor only moves when the two drift
+         * apart by more than a buffer, so callback jitter never reaches cue placement.
+         */
+        void beginBuffer() {
+            uint64_t const now = microsecondsSource();
+            double const expected = anchorMicroseconds + (sampleClock - anchorSample) * 1e6 / rate;
+            double const drift = std::abs(expected - (double) now);
+            if (!isAnchored || drift > bufferSize * 1e6 / rate) {
+                anchorMicroseconds = now;
+                anchorSample = sampleClock;
+                isAnchored = true;
+            }
+
+            if (unreturnedCount > 0)
+                returnUnreturned();
+
+            audio_cue c;
+            while (cues.pop(c)) {
+                /* Only retire() still queues unstamped cues; a stop on its way to deletion needn't wait for the latency. */
+                c.targetSample = (c.targetMicroseconds == audio_cue::IMMEDIATELY) ? sampleClock : sampleAtMicroseconds(c.targetMicroseconds);
+                if (pendingCount < maxPendingCues) {
+                    pendingCues[pendingCount++] = c;
+                    nextCueSample = std::min(nextCueSample, c.targetSample);
+                } else {
+                    apply(c);
+                }
+            }
+
+            if (removalsPending.load(std::memory_order_seq_cst) > 0)
+                applyRemovedCues();
+        }
+
+        /* Applies every pending cue naming a mix that remove() is waiting on, so none of them outlives the mix. */
+        void applyRemovedCues() {
+            nextCueSample = UINT64_MAX;
+            int kept = 0;
+            for (int i = 0; i < pendingCount; i++) {
+                mix_t *mix = pendingCues[i].mix;
+                if (mix != nullptr && mix->isRemoved.load(std::memory_order_acquire)) {
+                    apply(pendingCues[i]);
+                } else {
+                    nextCueSample = std::min(nextCueSample, pendingCues[i].targetSample);
+                    pendingCues[kept++] = pendingCues[i];
+                }
+            }
+            pendingCount = kept;
+        }
+
+        /*
+         * remove()'s fallback while no callback runs: the cueing thread stands in for the audio
+         * thread, applying the queued and pending cues that name removed mixes and putting the
+         * rest back in order.
+         */
+        void applyRemovedCuesWhileStopped() {
+            std::size_t const queued = cues.size();
+            for (std::size_t i = 0; i < queued; i++) {
+                audio_cue c;
+                cues.pop(c);
+                if (c.mix != nullptr && c.mix->isRemoved.load(std::memory_order_acquire))
+                    apply(c);
+                else
+                    cues.push(c);
+            }
+            applyRemovedCues();
+        }
+
+        /* Applies due cues in the order they were queued, so a start and stop landing on one sample keep their order. */
+        void applyDueCues() {
+            nextCueSample = UINT64_MAX;
+            int kept = 0;
+            for (int i = 0; i < pendingCount; i++) {
+                if (pendingCues[i].targetSample <= sampleClock) {
+                    apply(pendingCues[i]);
+                } else {
+                    nextCueSample = std::min(nextCueSample, pendingCues[i].targetSample);
+                    pendingCues[kept++] = pendingCues[i];
+                }
+            }
+            pendingCount = kept;
+        }
+
+        void apply(const audio_cue &c) {
+            switch (c.type) {
+                case audio_cue::START_MIX:
+                    if ((c.mix->cueReferences.load(std::memory_order_acquire) & RETIRED) == 0
+                            && !c.mix->isRemoved.load(std::memory_order_acquire) && mixes.add(c.mix))
+                        c.mix->state.store(mix_t::PLAYING, std::memory_order_release);
+                    else
+                        c.mix->state.store(mix_t::STOPPED, std::memory_order_release);
+                    release(c.mix);
+                    break;
+                case audio_cue::STOP_MIX:
+                    mixes.remove(c.mix);
+                    c.mix->state.store(mix_t::STOPPED, std::memory_order_release);
+                    release(c.mix);
+                    break;
+                case audio_cue::PLAY_SAMPLE:
+                    c.sample->setPosition(0);
+                    samples.add(c.sample);
+                    break;
+                case audio_cue::LOOP_SAMPLE:
+                    /* Past the reserved capacity push_back would allocate here, so the loop is dropped instead. */
+                    if (loops.size() < maxLoops) {
+                        loops.push_back(c.loop);
+                    } else {
+                        c.loop->remaining.store(0, std::memory_order_release);
+                        releaseShared(c.loop);
+                    }
+                    break;
+                case audio_cue::REVERSE_SAMPLE:
+                    startReverse(c);
+                    break;
+                case audio_cue::RESUME_SAMPLE:
+                    samples.remove(c.reverse->backward);
+                    samples.add(c.reverse->forward);
+                    c.reverse->state.store(sample_reverse::DONE, std::memory_order_release);
+                    releaseShared(c.reverse);
+                    break;
+            }
+        }
+
+        void startReverse(const audio_cue &c) {
+            sample_reverse *reverse = c.reverse;
+            reverse->backward->setPosition(1 - reverse->forward->getPosition());
+            reverse->forward->setPositionSeconds(std::max(0.0, reverse->forward->getPositionSeconds() - reverse->lengthSeconds));
+            samples.remove(reverse->forward);
+            samples.add(reverse->backward);
+            reverse->state.store(sample_reverse::REVERSING, std::memory_order_release);
+
+            audio_cue resume = audio_cue::make(audio_cue::RESUME_SAMPLE, audio_cue::IMMEDIATELY, nullptr, nullptr, nullptr);
+            resume.reverse = reverse;
+            resume.targetSample = c.targetSample + (uint64_t) (reverse->lengthSeconds * rate);
+            if (pendingCount < maxPendingCues) {
+                pendingCues[pendingCount++] = resume;
+                nextCueSample = std::min(nextCueSample, resume.targetSample);
+            } else {
+                apply(resume);
+            }
+        }
+
+        void assertProducer() {
+            std::thread::id owner;
+            producer.compare_exchange_strong(owner, std::this_thread::get_id(), std::memory_order_relaxed);
+            assert(owner == std::thread::id() || owner == std::this_thread::get_id());
+        }
+
+        /* Drops an applied cue's hold on its mix; the last one on a retired mix sends it back to be deleted. */
+        void release(mix_t *mix) {
+            if (mix->cueReferences.fetch_sub(2, std::memory_order_acq_rel) - 2 == RETIRED) {
+                /* Out of the table, this callback will not touch it again. */
+                mixes.remove(mix);
+                handBack(mix);
+            }
+        }
+
+        /* Drops the audio thread's hold on a loop or reverse it is finished with; sends it back if its owner already let go. */
+        void releaseShared(audio_shared *shared) {
+            if (shared->holders.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                handBack(shared);
+        }
+
+        void handBack(audio_retirable *retiree) {
+            if (unreturnedCount > 0 || !retired.push(retiree))
+                keepUnreturned(retiree);
+        }
+
+        /*
+         * Holds a retiree the producer hasn't made room for yet; beginBuffer() hands it back
+         * later, in order. If even this fills the retiree is leaked rather than deleted here.
+         */
+        void keepUnreturned(audio_retirable *retiree) {
+            if (unreturnedCount < maxUnreturned)
+                unreturned[unreturnedCount++] = retiree;
+        }
+
+        void returnUnreturned() {
+            int returned = 0;
+            while (returned < unreturnedCount && retired.push(unreturned[returned]))
+                returned++;
+            std::copy(unreturned + returned, unreturned + unreturnedCount, unreturned);
+            unreturnedCount -= returned;
+        }
+
+        void renderBlock(int length) {
+            std::fill(block, block + length, 0.0f);
+
+            std::size_t const mixCount = mixes.getHighWater();
+            for (std::size_t m = 0; m < mixCount; m++) {
+                mix_t *mix = mixes.get(m);
+                if (mix == nullptr)
+                    continue;
+                mix->render(voice, length);
+                accumulate(block, voice, 1.0f, length);
+            }
+
+            float const gain = volume;
+            std::size_t const sampleCount = samples.getHighWater();
+            for (std::size_t s = 0; s < sampleCount; s++) {
+                ofxMaxiSample *sample = samples.get(s);
+                if (sample == nullptr)
+                    continue;
+                bool const isFinished = renderSample(sample, length);
+                accumulate(block, voice, gain, length);
+                if (isFinished)
+                    samples.remove(sample);
+            }
+
+            sampleClock += length;
+        }
+
+        /* Renders a sample voice into voice, applying any loop on it; returns true once the sample has finished. */
+        bool renderSample(ofxMaxiSample *sample, int length) {
+            sample_loop *loop = nullptr;
+            for (auto l : loops) {
+                if (l->sample == sample) {
+                    loop = l;
+                    break;
+                }
+            }
+
+            for (int i = 0; i < length; i++) {
+                voice[i] = sample->playOnce();
+                if (loop != nullptr && sample->getPosition() >= loop->endPercent) {
+                    sample->setPosition(loop->startPercent);
+                    if (retrigger(loop))
+                        loop = nullptr;
+                }
+                if (sample->isDone()) {
+                    /* A loop still counting down would otherwise never reach 0 and its waiter never finish. */
+                    if (loop != nullptr)
+                        dropLoop(loop);
+                    std::fill(voice + i + 1, voice + length, 0.0f);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /* Counts down a loop; returns true once it has run out and been dropped. */
+        bool retrigger(sample_loop *loop) {
+            int const remaining = loop->remaining.load(std::memory_order_relaxed) - 1;
+            if (remaining > 0) {
+                loop->remaining.store(remaining, std::memory_order_release);
+                return false;
+            }
+            dropLoop(loop);
+            return true;
+        }
+
+        void dropLoop(sample_loop *loop) {
+            loops.erase(std::remove(loops.begin(), loops.end(), loop), loops.end());
+            loop->remaining.store(0, std::memory_order_release);
+            releaseShared(loop);
+        }
+
+        static void accumulate(float *destination, const float *source, float gain, int length) {
+            int i = 0;
+#if defined(__SSE__)
+            __m128 const g = _mm_set1_ps(gain);
+            for (; i + 4 <= length; i += 4) {
+                __m128 const sum = _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), g));
+                _mm_storeu_ps(destination + i, sum);
+            }
+#elif defined(__ARM_NEON)
+            float32x4_t const g = vdupq_n_f32(gain);
+            for (; i + 4 <= length; i += 4) {
+                vst1q_f32(destination + i, vmlaq_f32(vld1q_f32(destination + i), vld1q_f32(source + i), g));
+            }
+#endif
+            for (; i < length; i++)
+                destination[i] += source[i] * gain;
+        }
+
+        ofxBenG::voice_table<mix_t, maxVoices> mixes;
+        ofxBenG::voice_table<ofxMaxiSample, maxVoices> samples;
+        std::atomic<uint64_t> renderEpoch = {0};
+        std::atomic<int> removalsPending = {0};
+        std::atomic<bool> isRunning = {false};
+        std::vector<sample_loop*> loops;
         ofxBenG::property<float> volume = {"volume", 0.75, 0.0, 1.0};
+        ofxBenG::spsc_queue<audio_cue, 1024> cues;
+        ofxBenG::spsc_queue<audio_retirable*, 1024> retired;
+        audio_retirable *unreturned[maxUnreturned];
+        int unreturnedCount = 0;
+        std::atomic<std::thread::id> producer = {std::thread::id()};
+        std::thread::id callbackThread;
+        audio_cue pendingCues[maxPendingCues];
+        int pendingCount = 0;
+        uint64_t nextCueSample = UINT64_MAX;
+        uint64_t sampleClock = 0;
+        uint64_t anchorSample = 0;
+        uint64_t anchorMicroseconds = 0;
+        bool isAnchored = false;
+        float block[maxBlockFrames];
+        float voice[maxBlockFrames];
+        float monoBuffer[bufferSize];
+        int monoPosition = bufferSize;
+        std::function<uint64_t()> microsecondsSource;
     };
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,12 +2,57 @@
 
 using namespace ofxBenG;
 
-bool beat_action_comparator::operator()(beat_action *first, beat_action *second) {
-    return first->getTriggerBeat() > second->getTriggerBeat();
+frame_clock const *beat_action::currentFrame = nullptr;
+
+float beat_wheel_traits::keyOf(beat_action *action) {
+    return action->triggerBeat;
+}
+
+beat_action *&beat_wheel_traits::nextOf(beat_action *action) {
+    return action->nextScheduled;
+}
+
+uint64_t time_wheel_traits::keyOf(beat_action *action) {
+    return action->triggerMicroseconds;
+}
+
+beat_action *&time_wheel_traits::nextOf(beat_action *action) {
+    return action->nextScheduled;
+}
+
+void action_list::push_back(beat_action *action) {
+    action->previousRunning = tail;
+    action->nextRunning = nullptr;
+    if (tail != nullptr)
+        tail->nextRunning = action;
+    else
+        head = action;
+    tail = action;
+    count++;
+}
+
+beat_action *action_list::erase(beat_action *action) {
+    beat_action *next = action->nextRunning;
+    if (action->previousRunning != nullptr)
+        action->previousRunning->nextRunning = next;
+    else
+        head = next;
+    if (next != nullptr)
+        next->previousRunning = action->previousRunning;
+    else
+        tail = action->previousRunning;
+    action->previousRunning = nullptr;
+    action->nextRunning = nullptr;
+    count--;
+    return next;
+}
+
+beat_action *action_list::front() {
+    return head;
 }
 
-bool time_action_comparator::operator()(beat_action *first, beat_action *second) {
-    return first->getTriggerMicroseconds() > second->getTriggerMicroseconds();
+std::size_t action_list::size() {
+    return count;
 }
 
 beat_action::beat_action() {
@@ -16,24 +61,60 @@ beat_action::beat_action() {
 beat_action::~beat_action() {
 }
 
+void *beat_action::operator new(std::size_t size) {
+    return action_pool::allocate(size);
+}
+
+void beat_action::operator delete(void *p, std::size_t size) {
+    action_pool::release(p, size);
+}
+
+beat_action::frame_scope::frame_scope(const frame_clock &clock)
+        : clock(clock),
+          isOutermost(currentFrame == nullptr) {
+    if (isOutermost)
+        currentFrame = &this->clock;
+}
+
+beat_action::frame_scope::~frame_scope() {
+    if (isOutermost)
+        currentFrame = nullptr;
+}
+
+frame_clock beat_action::getClock() {
+    return (currentFrame != nullptr) ? *currentFrame : ofxBenG::ableton()->getFrameClock();
+}
+
 void beat_action::update() {
+    update(getClock());
+}
+
+void beat_action::update(const frame_clock &clock) {
+    frame_scope scope(clock);
     queueTriggeredActions();
     updateRunningActions();
     updateThisAction();
 }
 
 void beat_action::cue(beat_action *action) {
+    frame_scope scope(getClock());
     runningActions.push_back(action);
     action->startThisAction();
 }
 
-void beat_action::cue(std::function<void()> action) {
-    auto genericAction = new ofxBenG::generic_action(action);
+void beat_action::cue(action_function action) {
+    frame_scope scope(getClock());
+    auto genericAction = new ofxBenG::generic_action(std::move(action));
     runningActions.push_back(genericAction);
     genericAction->startThisAction();
 }
 
 void beat_action::start() {
+    start(getClock());
+}
+
+void beat_action::start(const frame_clock &clock) {
+    frame_scope scope(clock);
     queueTriggeredActions();
     startThisAction();
 }
@@ -43,51 +124,52 @@ bool beat_action::isThisActionDone() {
 }
 
 void beat_action::clearScheduledActions() {
-    scheduledActions = std::priority_queue<ofxBenG::beat_action *, std::vector<ofxBenG::beat_action *>, ofxBenG::beat_action_comparator>();
-    scheduledTimeActions.empty();
+    scheduledActions.clear();
+    scheduledTimeActions.clear();
 }
 
 void beat_action::schedule(float baseBeat, float beatsFromBase, beat_action *action) {
     float const scheduledBeat = baseBeat + beatsFromBase;
     action->setTriggerBeat(scheduledBeat);
-    scheduledActions.push(action);
+    scheduledActions.insert(action, getClock().beat);
 }
 
 void beat_action::cueInSeconds(float secondsFromNow, beat_action *action) {
     uint64_t microsecondsFromNow = (uint64_t)floor(1e6 * secondsFromNow);
-    uint64_t scheduledMicroseconds = ofGetElapsedTimeMicros() + microsecondsFromNow;
+    uint64_t const nowMicroseconds = getClock().microseconds;
+    uint64_t scheduledMicroseconds = nowMicroseconds + microsecondsFromNow;
     action->setTriggerMicroseconds(scheduledMicroseconds);
-    scheduledTimeActions.push(action);
+    scheduledTimeActions.insert(action, nowMicroseconds);
 }
 
-void beat_action::cueInSeconds(float secondsFromNow, std::function<void()> action) {
-    cueInSeconds(secondsFromNow, new generic_action(action));
+void beat_action::cueInSeconds(float secondsFromNow, action_function action) {
+    cueInSeconds(secondsFromNow, new generic_action(std::move(action)));
 }
 
 void beat_action::schedule(float beatsFromNow, beat_action *action) {
-    schedule(ofxBenG::ableton()->getBeat(), beatsFromNow, action);
+    schedule(getClock().beat, beatsFromNow, action);
 }
 
-void beat_action::schedule(float beatsFromNow, std::function<void()> action) {
-    schedule(beatsFromNow, new generic_action(action));
+void beat_action::schedule(float beatsFromNow, action_function action) {
+    schedule(beatsFromNow, new generic_action(std::move(action)));
 }
 
 void beat_action::scheduleOnNthBeatFromNow(int wholeBeatsFromNow, beat_action *action) {
-    float beat = floor(ofxBenG::ableton()->getBeat() + wholeBeatsFromNow);
+    float beat = floor(getClock().beat + wholeBeatsFromNow);
     schedule(beat, 0, action);
 }
 
-void beat_action::scheduleOnNthBeatFromNow(int wholeBeatsFromNow, std::function<void()> action) {
-    float beat = floor(ofxBenG::ableton()->getBeat() + wholeBeatsFromNow);
-    schedule(beat, 0, new generic_action(action));
+void beat_action::scheduleOnNthBeatFromNow(int wholeBeatsFromNow, action_function action) {
+    float beat = floor(getClock().beat + wholeBeatsFromNow);
+    schedule(beat, 0, new generic_action(std::move(action)));
 }
 
 void beat_action::scheduleNextWholeBeat(beat_action *action) {
-    schedule(ofxBenG::ableton()->getNextWholeBeat(), 0, action);
+    schedule(ceil(getClock().beat), 0, action);
 }
 
 void beat_action::scheduleNextWholeMeasure(beat_action *action) {
-    float beat = ofxBenG::ableton()->getBeat();
+    float beat = getClock().beat;
     while (int(floor(beat)) % 4 != 0) beat += 1;
     schedule(floor(beat), 0, action);
 }
@@ -117,42 +199,53 @@ bool beat_action::isScheduleDone() {
 }
 
 void beat_action::updateRunningActions() {
-    for (auto it = runningActions.begin(); it != runningActions.end();) {
-        beat_action *action = *it;
-        action->update();
+    beat_action *action = runningActions.front();
+    frame_clock const clock = getClock();
+    while (action != nullptr) {
+        action->update(clock);
         if (action->isDone()) {
-            it = this->runningActions.erase(it);
-            delete action;
+            beat_action *finished = action;
+            action = runningActions.erase(finished);
+            delete finished;
         } else {
-            it++;
+            action = action->nextRunning;
         }
     }
 }
 
 void beat_action::queueTriggeredActions() {
-    beat_action *nextAction;
-    
-    while (scheduledActions.size() > 0) {
-        nextAction = scheduledActions.top();
-        if (ofxBenG::ableton()->getBeat() >= nextAction->getTriggerBeat()) {
-            scheduledActions.pop();
-            runningActions.push_back(nextAction);
-            nextAction->start();
-        } else {
-            break;
-        }
+    if (scheduledActions.size() == 0 && scheduledTimeActions.size() == 0)
+        return;
+
+    frame_clock const clock = getClock();
+    if (scheduledActions.size() > 0) {
+        std::size_t const first = triggeredActions().size();
+        scheduledActions.advance(clock.beat, triggeredActions());
+        startTriggeredActions(first);
     }
-    
-    while (scheduledTimeActions.size() > 0) {
-        nextAction = scheduledTimeActions.top();
-        if (ofGetElapsedTimeMicros() >= nextAction->getTriggerMicroseconds()) {
-            scheduledTimeActions.pop();
-            runningActions.push_back(nextAction);
-            nextAction->start();
-        } else {
-            break;
-        }
+
+    if (scheduledTimeActions.size() > 0) {
+        std::size_t const first = triggeredActions().size();
+        scheduledTimeActions.advance(clock.microseconds, triggeredActions());
+        startTriggeredActions(first);
+    }
+}
+
+/* Reads by index, since a nested start may append and reallocate. */
+void beat_action::startTriggeredActions(std::size_t first) {
+    std::vector<beat_action *> &triggered = triggeredActions();
+    std::size_t const end = triggered.size();
+    for (std::size_t i = first; i < end; i++) {
+        beat_action *nextAction = triggered[i];
+        runningActions.push_back(nextAction);
+        nextAction->start();
     }
+    triggered.resize(first);
+}
+
+std::vector<beat_action *> &beat_action::triggeredActions() {
+    static std::vector<beat_action *> triggered;
+    return triggered;
 }
 
 flicker::flicker(ofxBenG::video_stream *stream,
@@ -174,17 +267,15 @@ flicker::flicker(ofxBenG::video_stream *stream,
         lightLevelMax(lightLevelMax),
         lastFlicker(lastFlicker),
         isHoldingFrame(false),
-        holdFrame(nullptr) {
-    recordingFps = stream->getFps();
-    int const size = ofxBenG::utilities::beatsToSeconds(videoLengthBeats, ofxBenG::ableton()->getTempo()) * recordingFps;
-    buffer = stream->makeBuffer(size);
-    header = new ofxPm::VideoHeader;
-    renderer = new ofxPm::BasicVideoRenderer;
+        holdFrame(nullptr),
+        showing(nullptr) {
+    recording = stream->makeWindow();
+    header = new ofxBenG::frame_header;
 }
 
 flicker::~flicker() {
     delete header;
-    delete buffer;
+    delete recording;
 }
 
 void flicker::draw(ofPoint windowSize) {
@@ -197,8 +288,8 @@ void flicker::draw(ofPoint windowSize) {
 
     if (holdFrame != nullptr) {
         holdFrame->draw(0, 0, windowSize[0], windowSize[1]);
-    } else if (renderer->isSetup()) {
-        renderer->draw(0, 0, windowSize[0], windowSize[1]);
+    } else if (showing != nullptr) {
+        showing->draw(0, 0, windowSize[0], windowSize[1]);
     }
 }
 
@@ -210,40 +301,40 @@ void flicker::startThisAction() {
 
     // Play last recording forwards
     if (lastFlicker != nullptr) {
-        std::cout << ofxBenG::ableton()->getBeat() << ": Start playing last recording forwards" << std::endl;
+        std::cout << getClock().beat << ": Start playing last recording forwards" << std::endl;
         auto lastHeader = lastFlicker->getHeader();
-        renderer->setup(*lastHeader);
-        cue(new pan_video(lastHeader, lastFlicker->getVideoLengthBeats(), videoLengthBeats, ofxBenG::ableton()->getTempo(), recordingFps, pan_video::PLAY_FORWARDS));
+        showing = lastHeader;
+        cue(new pan_video(lastHeader, videoLengthBeats, pan_video::PLAY_FORWARDS));
     }
 
     // Fade in the lights
-    std::cout << ofxBenG::ableton()->getBeat() << ": Start fading in" << std::endl;
+    std::cout << getClock().beat << ": Start fading in" << std::endl;
     cue(fade(lightLevelMin, lightLevelMax));
     acc += videoLengthBeats;
 
     // Start recording and play this buffer live
     schedule(acc, [this]() {
-        std::cout << ofxBenG::ableton()->getBeat() << ": Start recording" << std::endl;
+        std::cout << getClock().beat << ": Start recording" << std::endl;
         isBlackout = false;
-        buffer->resume();
-        header->setup(*buffer);
-        renderer->setup(*header);
+        recording->resume();
+        header->setup(*recording);
+        showing = header;
     });
     acc += videoLengthBeats;
 
     // Stop recording, fade out the lights, and hold the video
     schedule(acc, [this]() {
-        std::cout << ofxBenG::ableton()->getBeat() << ": Start fading out" << std::endl;
-        holdFrame = renderer->getLastTexture();
-        buffer->stop();
+        std::cout << getClock().beat << ": Start fading out" << std::endl;
+        holdFrame = &showing->getTexture();
+        recording->stop();
         cue(fade(lightLevelMax, lightLevelMin));
     });
     acc += videoLengthBeats;
 
     schedule(acc, [this]() {
-        std::cout << ofxBenG::ableton()->getBeat() << ": Start playing this recording backwards" << std::endl;
+        std::cout << getClock().beat << ": Start playing this recording backwards" << std::endl;
         holdFrame = nullptr;
-        cue(new pan_video(header, videoLengthBeats, videoLengthBeats, ofxBenG::ableton()->getTempo(), recordingFps, pan_video::PLAY_BACKWARDS));
+        cue(new pan_video(header, videoLengthBeats, pan_video::PLAY_BACKWARDS));
     });
     acc += videoLengthBeats;
 
@@ -267,7 +358,7 @@ float flicker::getVideoLengthBeats() {
     return videoLengthBeats;
 }
 
-ofxPm::VideoHeader *flicker::getHeader() {
+ofxBenG::frame_header *flicker::getHeader() {
     return header;
 }
 
@@ -284,11 +375,11 @@ lfo_action::lfo_action(float frequency, float startY, bool isHolding)
 }
 
 void lfo_action::startThisAction() {
-    phase -= beatsToRadian(ofxBenG::ableton()->getBeat());
+    phase -= beatsToRadian(getClock().beat);
 }
 
 void lfo_action::updateThisAction() {
-    float const beat = ofxBenG::ableton()->getBeat();
+    float const beat = getClock().beat;
     float y = sin(beat * TWO_PI * frequency + phase);
     if (!isHolding)
         ofNotifyEvent(onLfoValue, y);
@@ -311,7 +402,7 @@ void lfo_action::setFrequency(float value) {
 }
 
 float lfo_action::beatsToRadian(float beat) {
-    float secondsPerBeat = 60.0f / ofxBenG::ableton()->getTempo();
+    float secondsPerBeat = 60.0f / getClock().tempo;
     return beat * secondsPerBeat * frequency * TWO_PI;
 }
 
@@ -326,17 +417,17 @@ lerp_action::lerp_action(float seconds, floatFunction onValue)
 }
 
 void lerp_action::startThisAction() {
-    startMicroseconds = ofGetElapsedTimeMicros();
+    startMicroseconds = getClock().microseconds;
     endMicroseconds = startMicroseconds + microseconds;
 }
 
 void lerp_action::updateThisAction() {
-    float const currentMicros = ofGetElapsedTimeMicros();
+    float const currentMicros = getClock().microseconds;
     onValue(ofMap(currentMicros, startMicroseconds, endMicroseconds, 0, 1, true), myMin, myMax);
 }
 
 bool lerp_action::isThisActionDone() {
-    return ofGetElapsedTimeMicros() > endMicroseconds;
+    return getClock().microseconds > endMicroseconds;
 }
 
 std::string lerp_action::getLabel() {
@@ -346,3 +437,29 @@ std::string lerp_action::getLabel() {
 float lerp_action::map(float value, float targetMin, float targetMax) {
     return ofMap(value, myMin, myMax, targetMin, targetMax, false);
 }
+
+morph_action::morph_action(property_morph &morph, const std::vector<std::shared_ptr<const property_snapshot>> &presets, float beatsPerLeg)
+        : morph(morph),
+          presets(presets),
+          beatsPerLeg(beatsPerLeg) {
+
+}
+
+void morph_action::startThisAction() {
+    morph.start(presets, getClock().beat, beatsPerLeg);
+    isFinalApplied = false;
+}
+
+void morph_action::updateThisAction() {
+    float const beat = getClock().beat;
+    morph.update(beat);
+    isFinalApplied = morph.isDone(beat);
+}
+
+bool morph_action::isThisActionDone() {
+    return isFinalApplied;
+}
+
+std::string morph_action::getLabel() {
+    return "morph_action { presets:" + ofToString(presets.size()) + ", endBeat:" + ofToString(morph.getEndBeat()) + " }";
+}
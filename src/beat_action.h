@@ -3,7 +3,6 @@
 
 #include <algorithm>
 #include <vector>
-#include <queue>
 #include "ofxPlaymodes.h"
 #include "audio.h"
 #include "ease.h"
@@ -14,47 +13,80 @@
 #include "window_view.h"
 #include "video_stream.h"
 #include "etc_element.h"
+#include "timing_wheel.h"
+#include "action_pool.h"
+#include "inplace_function.h"
+#include "property_morph.h"
 
 #define MICROSECONDS_IN_SECOND 1e6
 #define UNDEFINED_MICROSECONDS 0xFFFFFFFFFFFFFFFF
 #define UNDEFINED_BEAT -1
+#define WHEEL_TICKS_PER_BEAT 64
+#define WHEEL_TICKS_PER_MICROSECOND 1e-3
 
 namespace ofxBenG {
 
     class beat_action;
 
-    class beat_action_comparator {
+    /* Captures of up to 64 bytes are stored inline; bigger ones still work but cost a heap allocation per action. */
+    typedef ofxBenG::inplace_function<void()> action_function;
+
+    class beat_wheel_traits {
     public:
-        bool operator()(beat_action *first, beat_action *second);
+        static float keyOf(beat_action *action);
+        static beat_action *&nextOf(beat_action *action);
     };
 
-    class time_action_comparator {
+    class time_wheel_traits {
     public:
-        bool operator()(beat_action *first, beat_action *second);
+        static uint64_t keyOf(beat_action *action);
+        static beat_action *&nextOf(beat_action *action);
+    };
+
+    /* Slots come from action_pool, so an action that schedules doesn't reach the heap once the pool has warmed up. */
+    typedef timing_wheel<beat_action, float, beat_wheel_traits, action_pool> beat_wheel;
+    typedef timing_wheel<beat_action, uint64_t, time_wheel_traits, action_pool> time_wheel;
+
+    /* Intrusive list of running actions, linked through the actions themselves. */
+    class action_list {
+    public:
+        void push_back(beat_action *action);
+        beat_action *erase(beat_action *action);
+        beat_action *front();
+        std::size_t size();
+
+    private:
+        beat_action *head = nullptr;
+        beat_action *tail = nullptr;
+        std::size_t count = 0;
     };
 
     class beat_action {
     public:
         beat_action();
         virtual ~beat_action();
+        static void *operator new(std::size_t size);
+        static void operator delete(void *p, std::size_t size);
         virtual std::string getLabel() = 0;
         virtual void cue(beat_action *action);
-        virtual void cue(std::function<void()> action);
+        virtual void cue(action_function action);
         virtual void startThisAction() = 0;
         virtual void updateThisAction() = 0;
         virtual bool isThisActionDone();
         virtual void clearScheduledActions();
         virtual void cueInSeconds(float secondsFromNow, beat_action *action);
-        virtual void cueInSeconds(float secondsFromNow, std::function<void()> action);
+        virtual void cueInSeconds(float secondsFromNow, action_function action);
         virtual void schedule(float baseBeat, float beatsFromBase, beat_action *action);
         virtual void schedule(float beatsFromNow, beat_action *action);
-        virtual void schedule(float beatsFromNow, std::function<void()> action);
+        virtual void schedule(float beatsFromNow, action_function action);
         virtual void scheduleOnNthBeatFromNow(int wholeBeatsFromNow, beat_action *action);
-        virtual void scheduleOnNthBeatFromNow(int wholeBeatsFromNow, std::function<void()> action);
+        virtual void scheduleOnNthBeatFromNow(int wholeBeatsFromNow, action_function action);
         virtual void scheduleNextWholeBeat(beat_action *action);
         virtual void scheduleNextWholeMeasure(beat_action *action);
         virtual void start();
+        virtual void start(const frame_clock &clock);
         virtual void update();
+        virtual void update(const frame_clock &clock);
         virtual float getTriggerBeat();
         virtual void setTriggerBeat(float value);
         virtual uint64_t getTriggerMicroseconds();
@@ -62,16 +94,44 @@ namespace ofxBenG {
         virtual bool isDone();
 
     protected:
-        std::deque<ofxBenG::beat_action *> runningActions;
-        std::priority_queue<ofxBenG::beat_action *, std::vector<ofxBenG::beat_action *>, ofxBenG::beat_action_comparator> scheduledActions;
-        std::priority_queue<ofxBenG::beat_action *, std::vector<ofxBenG::beat_action *>, ofxBenG::time_action_comparator> scheduledTimeActions;
+        frame_clock getClock();
+
+        ofxBenG::action_list runningActions;
+        ofxBenG::beat_wheel scheduledActions = {WHEEL_TICKS_PER_BEAT};
+        ofxBenG::time_wheel scheduledTimeActions = {WHEEL_TICKS_PER_MICROSECOND};
 
     private:
+        /* Publishes a frame's clock to every action evaluated while it is alive. */
+        class frame_scope {
+        public:
+            frame_scope(const frame_clock &clock);
+            ~frame_scope();
+
+        private:
+            frame_clock clock;
+            bool isOutermost;
+        };
+
         virtual void updateRunningActions();
         virtual void queueTriggeredActions();
+        void startTriggeredActions(std::size_t first);
         bool isScheduleDone();
+        /*
+         * Actions due this frame, shared by the whole tree so a freshly cued action doesn't
+         * grow a vector of its own the first time something it scheduled comes due. A nested
+         * queueTriggeredActions() appends after its caller's entries and trims back to them.
+         */
+        static std::vector<ofxBenG::beat_action *> &triggeredActions();
         float triggerBeat = UNDEFINED_BEAT;
         uint64_t triggerMicroseconds = UNDEFINED_MICROSECONDS;
+        beat_action *previousRunning = nullptr;
+        beat_action *nextRunning = nullptr;
+        beat_action *nextScheduled = nullptr;
+        static frame_clock const *currentFrame;
+
+        friend class action_list;
+        friend class beat_wheel_traits;
+        friend class time_wheel_traits;
     };
 
     class lfo_action : public beat_action {
@@ -96,7 +156,7 @@ namespace ofxBenG {
     };
 
     /* Linearly transition from 0 to 1 in a duration of seconds */
-    typedef std::function<void(float, float, float)> floatFunction;
+    typedef ofxBenG::inplace_function<void(float, float, float)> floatFunction;
     class lerp_action : public beat_action {
     public:
         lerp_action(float seconds, floatFunction onValue);
@@ -115,13 +175,30 @@ namespace ofxBenG {
         floatFunction onValue;
     };
 
+    /* Morph a property bag through presets, beatsPerLeg beats from one to the next, starting on the beat it is started */
+    class morph_action : public beat_action {
+    public:
+        morph_action(property_morph &morph, const std::vector<std::shared_ptr<const property_snapshot>> &presets, float beatsPerLeg);
+        virtual void startThisAction();
+        virtual void updateThisAction();
+        virtual bool isThisActionDone();
+        virtual std::string getLabel();
+
+    private:
+        property_morph &morph;
+        std::vector<std::shared_ptr<const property_snapshot>> presets;
+        float beatsPerLeg;
+        /* Set by the update that applied the last preset; isThisActionDone() only reads it. */
+        bool isFinalApplied = false;
+    };
+
     class record_action : public beat_action {
     public:
-        record_action(ofxPm::VideoBuffer *buffer) : buffer(buffer) {
+        record_action(ofxBenG::frame_window *recording) : recording(recording) {
         }
 
         virtual void startThisAction() {
-            buffer->resume();
+            recording->resume();
         }
 
         virtual std::string getLabel() {
@@ -129,16 +206,16 @@ namespace ofxBenG {
         }
 
     private:
-        ofxPm::VideoBuffer *buffer;
+        ofxBenG::frame_window *recording;
     };
 
     class stop_recording_action : public beat_action {
     public:
-        stop_recording_action(ofxPm::VideoBuffer *buffer) : buffer(buffer) {
+        stop_recording_action(ofxBenG::frame_window *recording) : recording(recording) {
         }
 
         virtual void startThisAction() {
-            buffer->stop();
+            recording->stop();
         }
 
         virtual std::string getLabel() {
@@ -146,19 +223,19 @@ namespace ofxBenG {
         }
 
     private:
-        ofxPm::VideoBuffer *buffer;
+        ofxBenG::frame_window *recording;
     };
 
     class resume_recording_action : public beat_action {
     public:
-        resume_recording_action(ofxPm::VideoBuffer *buffer) : buffer(buffer) {
+        resume_recording_action(ofxBenG::frame_window *recording) : recording(recording) {
         }
 
         virtual ~resume_recording_action() {
         };
 
         virtual void startThisAction() {
-            buffer->resume();
+            recording->resume();
         }
 
         virtual std::string getLabel() {
@@ -166,12 +243,12 @@ namespace ofxBenG {
         }
 
     private:
-        ofxPm::VideoBuffer *buffer;
+        ofxBenG::frame_window *recording;
     };
 
     class play_from_beginning_action : public beat_action {
     public:
-        play_from_beginning_action(ofxPm::VideoHeader *header) : header(header) {
+        play_from_beginning_action(ofxBenG::frame_header *header) : header(header) {
         }
 
         virtual ~play_from_beginning_action() {
@@ -187,60 +264,61 @@ namespace ofxBenG {
         }
 
     private:
-        ofxPm::VideoHeader *header;
+        ofxBenG::frame_header *header;
     };
 
+    /*
+     * Sweeps a frame_header across its window over lengthBeats, forwards or backwards. The
+     * shown frame is a function of the beat alone, mapped onto the frames the window really
+     * holds, so it does not drift with the render rate or an estimated capture rate, and
+     * slow sweeps crossfade between neighbouring frames instead of stepping.
+     */
     class pan_video : public beat_action {
     public:
-        pan_video(ofxPm::VideoHeader *header, float originalLengthBeats,
-                float targetLengthBeats, float bpm, float fps)
-                : pan_video(header, originalLengthBeats, targetLengthBeats, bpm, fps, PLAY_FORWARDS) {
+        pan_video(ofxBenG::frame_header *header, float lengthBeats)
+                : pan_video(header, lengthBeats, PLAY_FORWARDS) {
         }
 
-        pan_video(ofxPm::VideoHeader *header, float originalLengthBeats,
-                float targetLengthBeats, float bpm, float fps, bool playForwards)
-                : header(header), originalLengthBeats(originalLengthBeats),
-                  targetLengthBeats(targetLengthBeats), playForwards(playForwards), bpm(bpm), fps(fps) {
+        pan_video(ofxBenG::frame_header *header, float lengthBeats, bool playForwards)
+                : header(header), lengthBeats(lengthBeats), playForwards(playForwards) {
         }
 
         virtual void startThisAction() {
-            delayFrames = originalLengthBeats * (60 / bpm) * fps;
-            startBeat = ofxBenG::ableton()->getBeat();
-            header->setDelayFrames(playForwards ? delayFrames : 0);
-            std::cout << ofxBenG::ableton()->getBeat() << ": startPlayingBeat=" << startBeat
-                      << ", originalLengthBeats=" << originalLengthBeats
-                      << ", targetLengthBeats=" << targetLengthBeats
-                      << std::endl;
+            float const triggerBeat = getTriggerBeat();
+            startBeat = (triggerBeat != UNDEFINED_BEAT) ? triggerBeat : getClock().beat;
+            header->setBlending(true);
+            updateThisAction();
         }
 
         virtual void updateThisAction() {
-            float amount = (ofxBenG::ableton()->getBeat() - startBeat) / targetLengthBeats;
-            float lerp = ofLerp(0, delayFrames, amount);
-            float frames = (playForwards) ? delayFrames - lerp : lerp;
-            std::cout << "setDelayFrames(" << frames
-                      << std::endl;
-            header->setDelayFrames(frames);
+            header->setFramePosition(getFramePosition(getClock().beat, startBeat, lengthBeats, header->getFrameCount(), playForwards));
         }
 
         virtual bool isThisActionDone() {
-            return ofxBenG::ableton()->getBeat() >= startBeat + targetLengthBeats;
+            return getClock().beat >= startBeat + lengthBeats;
         }
 
         virtual std::string getLabel() {
             return "Pan Video";
         }
 
+        /* Fractional offset into frameCount frames reached at beat, clamped to the sweep. */
+        static double getFramePosition(float beat, float startBeat, float lengthBeats, std::size_t frameCount, bool playForwards) {
+            if (frameCount == 0)
+                return 0;
+            double const progress = lengthBeats > 0 ? ((double) beat - startBeat) / lengthBeats : 1;
+            double const amount = std::min(std::max(progress, 0.0), 1.0);
+            double const last = frameCount - 1;
+            return playForwards ? amount * last : (1 - amount) * last;
+        }
+
         static bool const PLAY_FORWARDS = true;
         static bool const PLAY_BACKWARDS = false;
     private:
         float startBeat;
-        float originalLengthBeats;
-        float targetLengthBeats;
-        float delayFrames;
-        float bpm;
-        float fps;
+        float lengthBeats;
         bool playForwards;
-        ofxPm::VideoHeader *header;
+        ofxBenG::frame_header *header;
     };
 
     class flicker : public beat_action, public window_view {
@@ -259,7 +337,7 @@ namespace ofxBenG {
         virtual void updateThisAction();
         virtual bool isThisActionDone();
         virtual std::string getLabel();
-        ofxPm::VideoHeader *getHeader();
+        ofxBenG::frame_header *getHeader();
         float getVideoLengthBeats();
 
     private:
@@ -267,15 +345,14 @@ namespace ofxBenG {
 
         ofxBenG::lerp_action *lerp;
         ofxBenG::video_stream *stream;
-        ofxPm::VideoBuffer *buffer;
-        ofxPm::VideoHeader *header;
-        ofxPm::BasicVideoRenderer *renderer;
+        ofxBenG::frame_window *recording;
+        ofxBenG::frame_header *header;
         ofTexture *holdFrame;
+        ofxBenG::frame_header *showing;
         ofxBenG::etc_element_osc_proxy *lightBoard;
         ofxBenG::flicker *lastFlicker;
         float blackoutLengthBeats;
         float videoLengthBeats;
-        float recordingFps;
         float faderNumber;
         float lightLevelMin;
         float lightLevelMax;
@@ -297,9 +374,12 @@ namespace ofxBenG {
             delete reverse;
         }
 
+        /* Stamped with its beat, like play_tone, so the audio thread turns the samples around sample-accurately. */
         virtual void startThisAction() {
-            float lengthSeconds = ofxBenG::utilities::beatsToSeconds(lengthBeats, bpm);
-            reverse = new maxim_reverse(forwardSample, backwardSample, lengthSeconds);
+            frame_clock const clock = getClock();
+            float const startBeat = (getTriggerBeat() != UNDEFINED_BEAT) ? getTriggerBeat() : clock.beat;
+            float const lengthSeconds = ofxBenG::utilities::beatsToSeconds(lengthBeats, bpm);
+            reverse = new maxim_reverse(forwardSample, backwardSample, lengthSeconds, startBeat, clock);
         }
 
         virtual void updateThisAction() {
@@ -315,7 +395,7 @@ namespace ofxBenG {
         }
 
     private:
-        ofxBenG::maxim_reverse *reverse;
+        ofxBenG::maxim_reverse *reverse = nullptr;
         ofxMaxiSample *forwardSample;
         ofxMaxiSample *backwardSample;
         float bpm;
@@ -350,32 +430,69 @@ namespace ofxBenG {
         }
 
     private:
-        ofxBenG::maxim_stutter *stutter;
+        ofxBenG::maxim_stutter *stutter = nullptr;
         ofxMaxiSample *sample;
         float bpm;
         float lengthBeats;
     };
 
+    /*
+     * A sine mix carrying its own oscillator, allocated from action_pool like the actions
+     * that cue it. The audio thread hands retired mixes back to the cueing thread for
+     * deletion, and that is the thread running the action tree, so the pool's
+     * single-thread rule holds.
+     */
+    struct tone_mix : public mix_t {
+        tone_mix(float frequency)
+                : mix_t([this](float *out, int frames) {
+                    for (int i = 0; i < frames; i++)
+                        out[i] = oscillator.sinewave(this->frequency) / 3;
+                }),
+                  frequency(frequency) {
+        }
+
+        static void *operator new(std::size_t size) {
+            return action_pool::allocate(size);
+        }
+
+        static void operator delete(void *p, std::size_t size) {
+            action_pool::release(p, size);
+        }
+
+        ofxMaxiOsc oscillator;
+        float frequency;
+    };
+
     class play_tone : public beat_action {
     public:
         play_tone(float durationBeats, float frequency)
                 : durationBeats(durationBeats), frequency(frequency) {
-            tone = new mix_t([this]() {
-                return this->oscillator.sinewave(this->frequency) / 3;
-            });
+            tone = new tone_mix(frequency);
         }
 
+        /* A cued tone may still be named by a pending cue, so the audio thread decides when it can be deleted. */
         virtual ~play_tone() {
-            ofxBenG::audio::getInstance()->remove(tone);
+            if (isCued) {
+                ofxBenG::audio::getInstance()->retire(tone);
+            } else {
+                delete tone;
+            }
         };
 
+        /* Onset and release are stamped with beats so the audio thread places them sample-accurately. */
         virtual void startThisAction() {
-            startBeat = ofxBenG::ableton()->getBeat();
-            ofxBenG::audio::getInstance()->add(tone);
+            frame_clock const clock = getClock();
+            startBeat = (getTriggerBeat() != UNDEFINED_BEAT) ? getTriggerBeat() : clock.beat;
+            auto audio = ofxBenG::audio::getInstance();
+            isCued = audio->cue(audio_cue::startMix(tone, startBeat, clock));
+            if (isCued)
+                audio->cue(audio_cue::stopMix(tone, startBeat + durationBeats, clock));
         }
 
+        /* Without a running stream the stop cue never lands, so the beat alone decides. */
         virtual bool isThisActionDone() {
-            return ofxBenG::ableton()->getBeat() >= startBeat + durationBeats;
+            return getClock().beat >= startBeat + durationBeats
+                    && (tone->isStopped() || !isCued || !ofxBenG::audio::getInstance()->isStreamRunning());
         }
 
         virtual std::string getLabel() {
@@ -389,13 +506,13 @@ namespace ofxBenG {
         float durationBeats;
         float startBeat;
         float frequency;
-        ofxBenG::mix_t *tone;
-        ofxMaxiOsc oscillator;
+        bool isCued = false;
+        ofxBenG::tone_mix *tone;
     };
 
     class generic_action : public beat_action {
     public:
-        generic_action(std::function<void()> action) : beat_action(), action(action) {
+        generic_action(action_function action) : beat_action(), action(std::move(action)) {
         }
 
         virtual void startThisAction() {
@@ -411,7 +528,7 @@ namespace ofxBenG {
         }
 
     private:
-        std::function<void()> action;
+        action_function action;
     };
 
     class timeline : public beat_action {
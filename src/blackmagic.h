@@ -72,12 +72,20 @@ namespace ofxBenG {
         }
         
         void update() {
-            if (isSetup) {
-                cam.update();
-                newFrame(cam.getColorPixels());
+            if (grab()) {
+                newFrame(getColorPixels());
             }
         }
 
+        /* Polls the card; true only when it delivered a frame since the last call. */
+        bool grab() {
+            return isSetup && cam.update();
+        }
+
+        ofPixels &getColorPixels() {
+            return cam.getColorPixels();
+        }
+
         void close() {
             if (isSetup) {
                 cam.close();
@@ -88,7 +96,6 @@ namespace ofxBenG {
         void newFrame(ofPixels& pixels) {
             if (pixels.isAllocated()) {
                 frame = ofxPm::VideoFrame::newVideoFrame(pixels);
-                frame.getTextureRef();
                 newFrameEvent.notify(this, frame);
             }
         }
@@ -0,0 +1,25 @@
+#ifndef frame_clock_h
+#define frame_clock_h
+
+#include <cstdint>
+
+namespace ofxBenG {
+
+    /* One Link query's worth of timing, shared by everything evaluated in the same frame. */
+    struct frame_clock {
+        float beat;
+        float phase;
+        float tempo;
+        uint64_t microseconds;
+
+        /* Wall-clock time at which this clock's timeline reaches beat, assuming a steady tempo. */
+        uint64_t microsecondsAtBeat(float targetBeat) const {
+            double const microsecondsPerBeat = 60e6 / tempo;
+            double const offset = (targetBeat - beat) * microsecondsPerBeat;
+            return (offset <= -(double) microseconds) ? 0 : (uint64_t) ((double) microseconds + offset);
+        }
+    };
+
+} // ofxBenG
+
+#endif /* frame_clock_h */
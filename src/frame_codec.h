@@ -0,0 +1,200 @@
+#ifndef frame_codec_h
+#define frame_codec_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ofxBenG {
+
+    /*
+     * Byte-oriented LZ compressor writing the LZ4 block format: greedy matching through a
+     * 64K-entry hash of 4-byte sequences, offsets up to 64K back. The search steps further
+     * the longer it goes without a match, so sensor noise passes through at memcpy-like
+     * speed. Matches under eight bytes are skipped: they save a few bytes at most, and low
+     * sensor noise throws them up every few bytes, each one resetting that step.
+     * decompress() checks every length and offset, so a block overwritten while it was
+     * being read fails instead of writing out of bounds.
+     */
+    class frame_codec {
+    public:
+        static std::size_t getBound(std::size_t size) {
+            return size + size / 255 + 16;
+        }
+
+        /* Returns the compressed size, or 0 if it did not fit in capacity. */
+        static std::size_t compress(const uint8_t *source, std::size_t size, uint8_t *destination, std::size_t capacity) {
+            std::vector<uint32_t> &table = getTable();
+            std::fill(table.begin(), table.end(), 0);
+
+            uint8_t *out = destination;
+            uint8_t *const outEnd = destination + capacity;
+            std::size_t anchor = 0;
+            std::size_t position = 0;
+            if (size >= MIN_INPUT) {
+                std::size_t const matchLimit = size - LAST_LITERALS;
+                std::size_t const startLimit = size - MATCH_START_MARGIN;
+                while (position < startLimit) {
+                    uint32_t const sequence = read32(source + position);
+                    uint32_t &slot = table[hash(sequence)];
+                    std::size_t const candidate = slot;
+                    slot = (uint32_t) position + 1;
+                    if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET || read32(source + candidate - 1) != sequence) {
+                        position += 1 + ((position - anchor) >> SKIP_SHIFT);
+                        continue;
+                    }
+
+                    std::size_t const match = candidate - 1;
+                    std::size_t const length = MIN_MATCH + countMatching(source + match + MIN_MATCH, source + position + MIN_MATCH,
+                                                                         matchLimit - position - MIN_MATCH);
+                    if (length < MIN_WORTHWHILE_MATCH) {
+                        position += 1 + ((position - anchor) >> SKIP_SHIFT);
+                        continue;
+                    }
+                    out = writeSequence(out, outEnd, source + anchor, position - anchor, position - match, length);
+                    if (out == nullptr)
+                        return 0;
+                    position += length;
+                    anchor = position;
+                }
+            }
+            out = writeSequence(out, outEnd, source + anchor, size - anchor, 0, 0);
+            return out == nullptr ? 0 : out - destination;
+        }
+
+        /* True if source decoded to exactly size bytes. */
+        static bool decompress(const uint8_t *source, std::size_t sourceSize, uint8_t *destination, std::size_t size) {
+            std::size_t in = 0;
+            std::size_t out = 0;
+            while (in < sourceSize) {
+                uint8_t const token = source[in++];
+                std::size_t literals = token >> 4;
+                if (!readLength(source, sourceSize, in, literals) || literals > sourceSize - in || literals > size - out)
+                    return false;
+                std::memcpy(destination + out, source + in, literals);
+                in += literals;
+                out += literals;
+                if (in == sourceSize)
+                    break;
+
+                if (sourceSize - in < 2)
+                    return false;
+                std::size_t const offset = source[in] | (source[in + 1] << 8);
+                in += 2;
+                std::size_t length = token & 15;
+                if (offset == 0 || offset > out || !readLength(source, sourceSize, in, length))
+                    return false;
+                length += MIN_MATCH;
+                if (length > size - out)
+                    return false;
+                const uint8_t *match = destination + out - offset;
+                uint8_t *target = destination + out;
+                if (offset >= length) {
+                    std::memcpy(target, match, length);
+                } else {
+                    /* A repeating pattern: copy one period, then keep doubling what is already written. */
+                    std::memcpy(target, match, offset);
+                    std::size_t copied = offset;
+                    while (copied < length) {
+                        std::size_t const chunk = std::min(copied, length - copied);
+                        std::memcpy(target + copied, target, chunk);
+                        copied += chunk;
+                    }
+                }
+                out += length;
+            }
+            return out == size;
+        }
+
+    private:
+        static std::size_t const MIN_MATCH = 4;
+        static std::size_t const MIN_WORTHWHILE_MATCH = 8;
+        static std::size_t const LAST_LITERALS = 5;
+        static std::size_t const MATCH_START_MARGIN = 12;
+        static std::size_t const MIN_INPUT = 13;
+        static std::size_t const MAX_OFFSET = 65535;
+        static std::size_t const SKIP_SHIFT = 6;
+        static int const HASH_BITS = 16;
+
+        static std::vector<uint32_t> &getTable() {
+            static thread_local std::vector<uint32_t> table(1 << HASH_BITS);
+            return table;
+        }
+
+        static uint32_t read32(const uint8_t *p) {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        /* Length of the common prefix of a and b, at most limit; compares eight bytes at a time. */
+        static std::size_t countMatching(const uint8_t *a, const uint8_t *b, std::size_t limit) {
+            std::size_t count = 0;
+            while (count + 8 <= limit) {
+                uint64_t x, y;
+                std::memcpy(&x, a + count, 8);
+                std::memcpy(&y, b + count, 8);
+                if (x != y)
+                    break;
+                count += 8;
+            }
+            while (count < limit && a[count] == b[count]) {
+                count++;
+            }
+            return count;
+        }
+
+        static uint32_t hash(uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        /* Appends a literal run and, unless length is 0, the match that follows it. */
+        static uint8_t *writeSequence(uint8_t *out, uint8_t *outEnd, const uint8_t *literals, std::size_t literalCount,
+                                      std::size_t offset, std::size_t length) {
+            std::size_t const worstCase = 1 + literalCount / 255 + 1 + literalCount + 2 + (length / 255 + 1);
+            if ((std::size_t) (outEnd - out) < worstCase)
+                return nullptr;
+
+            uint8_t *token = out++;
+            std::size_t const matchCode = length > 0 ? length - MIN_MATCH : 0;
+            *token = (uint8_t) ((std::min<std::size_t>(literalCount, 15) << 4) | std::min<std::size_t>(matchCode, 15));
+            out = writeLength(out, literalCount);
+            std::memcpy(out, literals, literalCount);
+            out += literalCount;
+            if (length > 0) {
+                *out++ = (uint8_t) (offset & 0xff);
+                *out++ = (uint8_t) (offset >> 8);
+                out = writeLength(out, matchCode);
+            }
+            return out;
+        }
+
+        static uint8_t *writeLength(uint8_t *out, std::size_t length) {
+            if (length >= 15) {
+                length -= 15;
+                while (length >= 255) {
+                    *out++ = 255;
+                    length -= 255;
+                }
+                *out++ = (uint8_t) length;
+            }
+            return out;
+        }
+
+        static bool readLength(const uint8_t *source, std::size_t sourceSize, std::size_t &in, std::size_t &length) {
+            if (length != 15)
+                return true;
+            uint8_t next;
+            do {
+                if (in >= sourceSize)
+                    return false;
+                next = source[in++];
+                length += next;
+            } while (next == 255);
+            return true;
+        }
+    };
+}
+
+#endif /* frame_codec_h */
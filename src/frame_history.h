@@ -0,0 +1,592 @@
+#ifndef frame_history_h
+#define frame_history_h
+
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ofMain.h"
+#include "frame_pool.h"
+#include "frame_spill.h"
+
+namespace ofxBenG {
+
+    /*
+     * The one ring of recent frames a stream keeps. Everything that plays the stream back
+     * reads it through frame_windows, so each captured frame is stored once no matter how
+     * many windows overlap it. Frames are addressed by absolute index: the n-th frame pushed
+     * is index n for as long as the ring, or the disk tier behind it, holds it.
+     *
+     * capture() converts on the calling thread. queueCapture() hands the conversion to the
+     * history's own worker thread instead, and finishCapture() waits for it and pushes the
+     * frame, so a render loop that finishes last frame's capture before grabbing the next
+     * one only waits if the worker has fallen a whole frame behind.
+     */
+    class frame_history {
+    public:
+        frame_history(std::size_t capacity) : frames(std::max<std::size_t>(capacity, 1)) {
+            reservePool();
+        }
+
+        ~frame_history() {
+            {
+                std::lock_guard<std::mutex> lock(converterMutex);
+                isConverterRunning = false;
+            }
+            conversionQueued.notify_one();
+            if (converter.joinable())
+                converter.join();
+        }
+
+        /*
+         * Keeps up to frames more frames on disk once they leave RAM, in a file created at
+         * path. False if the file could not be created; the history then stays RAM-only.
+         */
+        bool setSpill(const std::string &path, std::size_t frames, std::size_t readAhead = 8) {
+            spill.reset(new frame_spill(pool, frames, readAhead));
+            if (!spill->open(path)) {
+                spill.reset();
+                return false;
+            }
+            spillStart = getMemoryStart();
+            reservePool();
+            return true;
+        }
+
+        /* Copies pixels into a pooled slot and makes it the newest frame. False if the pool was exhausted. */
+        bool capture(const ofPixels &pixels, uint64_t timestamp) {
+            frame_ref frame = pool.capture(pixels, timestamp);
+            if (!frame)
+                return false;
+            push(std::move(frame));
+            return true;
+        }
+
+        /*
+         * Like capture(), but the worker thread converts pixels into the pool. pixels are read
+         * in place, so they must not change until finishCapture() returns; a capture still
+         * queued from before is finished first.
+         */
+        void queueCapture(const ofPixels &pixels, uint64_t timestamp) {
+            finishCapture();
+            {
+                std::lock_guard<std::mutex> lock(converterMutex);
+                if (!converter.joinable()) {
+                    isConverterRunning = true;
+                    converter = std::thread(&frame_history::convertLoop, this);
+                }
+                queuedPixels = &pixels;
+                queuedTimestamp = timestamp;
+                isCapturePending = true;
+            }
+            conversionQueued.notify_one();
+        }
+
+        /* Waits for the frame queueCapture() handed over and makes it the newest frame. False if none was queued or the pool was exhausted. */
+        bool finishCapture() {
+            frame_ref frame;
+            {
+                std::unique_lock<std::mutex> lock(converterMutex);
+                if (!isCapturePending)
+                    return false;
+                conversionDone.wait(lock, [this]() { return queuedPixels == nullptr; });
+                isCapturePending = false;
+                frame = std::move(convertedFrame);
+            }
+            if (!frame)
+                return false;
+            push(std::move(frame));
+            return true;
+        }
+
+        std::size_t getCapacity() const {
+            return frames.size() + (spill ? spill->getCapacity() : 0);
+        }
+
+        std::size_t size() const {
+            return pushedCount - getStart();
+        }
+
+        /* Index the next frame will get; getFrame() accepts [getPushedCount() - size(), getPushedCount()). */
+        uint64_t getPushedCount() const {
+            return pushedCount;
+        }
+
+        /* Index of the oldest frame still in RAM; older ones come from disk. */
+        uint64_t getMemoryStart() const {
+            return pushedCount - std::min<uint64_t>(pushedCount, frames.size());
+        }
+
+        /* An empty reference for a frame on disk that the read-ahead has not reached yet. */
+        frame_ref getFrame(uint64_t index) const {
+            if (index >= pushedCount || index < getStart())
+                return frame_ref();
+            if (index >= getMemoryStart())
+                return frames[index % frames.size()];
+            return spill->getFrame(index);
+        }
+
+        bool getTimestamp(uint64_t index, uint64_t &timestamp) const {
+            if (index >= pushedCount || index < getStart())
+                return false;
+            if (index >= getMemoryStart()) {
+                timestamp = frames[index % frames.size()]->getTimestamp();
+                return true;
+            }
+            return spill->getTimestamp(index, timestamp);
+        }
+
+        frame_pool &getPool() {
+            return pool;
+        }
+
+        /* Frames the disk tier dropped because it fell behind or could not store them. */
+        uint64_t getSpillDroppedCount() const {
+            return spill ? spill->getDroppedCount() : 0;
+        }
+
+    private:
+        friend class frame_window;
+
+        void push(frame_ref frame) {
+            frame_ref &slot = frames[pushedCount % frames.size()];
+            if (spill && pushedCount >= frames.size()) {
+                spill->write(std::move(slot), pushedCount - frames.size());
+            }
+            slot = std::move(frame);
+            pushedCount++;
+        }
+
+        void convertLoop() {
+            std::unique_lock<std::mutex> lock(converterMutex);
+            while (true) {
+                conversionQueued.wait(lock, [this]() { return !isConverterRunning || queuedPixels != nullptr; });
+                if (queuedPixels == nullptr)
+                    return;
+                const ofPixels *pixels = queuedPixels;
+                uint64_t const timestamp = queuedTimestamp;
+                lock.unlock();
+                frame_ref frame = pool.capture(*pixels, timestamp);
+                lock.lock();
+                convertedFrame = std::move(frame);
+                queuedPixels = nullptr;
+                conversionDone.notify_one();
+            }
+        }
+
+        /* A pinned frame can outlive its place in the ring, so the pool needs a slot for each. */
+        void pin(std::size_t count) {
+            pinnedCount += count;
+            reservePool();
+        }
+
+        void unpin(std::size_t count) {
+            pinnedCount -= count;
+        }
+
+        void reservePool() {
+            pool.reserve(frames.size() + pinnedCount + (spill ? spill->getPoolSlots() : 0) + 1);
+        }
+
+        uint64_t getStart() const {
+            uint64_t const memoryStart = getMemoryStart();
+            if (!spill)
+                return memoryStart;
+            uint64_t const diskStart = memoryStart - std::min<uint64_t>(memoryStart, spill->getCapacity());
+            return std::max(spillStart, diskStart);
+        }
+
+        frame_pool pool;
+        std::unique_ptr<frame_spill> spill;
+        std::vector<frame_ref> frames;
+        uint64_t pushedCount = 0;
+        uint64_t spillStart = 0;
+        std::atomic<std::size_t> pinnedCount = {0};
+
+        std::mutex converterMutex;
+        std::condition_variable conversionQueued;
+        std::condition_variable conversionDone;
+        /* The pixels the worker is converting, or null once convertedFrame holds the result. */
+        const ofPixels *queuedPixels = nullptr;
+        uint64_t queuedTimestamp = 0;
+        frame_ref convertedFrame;
+        bool isCapturePending = false;
+        bool isConverterRunning = false;
+        std::thread converter;
+    };
+
+    /*
+     * A view of part of a frame_history. A new window covers whatever the history holds and
+     * follows it. resume() starts a recording: the window begins at the next frame and grows
+     * with the history. stop() fixes its length and pins the frames it covers, so it keeps
+     * playing back after the ring has moved past them without copying any pixels. Frames
+     * already on disk when it stops are not pinned; they stay readable until the disk tier
+     * overwrites them.
+     */
+    class frame_window {
+    public:
+        frame_window(frame_history &history) : history(history) {}
+
+        ~frame_window() {
+            unpin();
+        }
+
+        /* Starts recording from the next captured frame, discarding what the window held. */
+        void resume() {
+            unpin();
+            start = history.getPushedCount();
+            isBounded = true;
+            isRecording = true;
+        }
+
+        void stop() {
+            if (!isRecording)
+                return;
+            end = history.getPushedCount();
+            start = std::max(start, history.getPushedCount() - history.size());
+            pinnedStart = std::max(start, history.getMemoryStart());
+            for (uint64_t i = pinnedStart; i < end; i++) {
+                pinned.push_back(history.getFrame(i));
+            }
+            history.pin(pinned.size());
+            isRecording = false;
+        }
+
+        bool isStopped() const {
+            return !isRecording;
+        }
+
+        void setLoop(bool loop) {
+            this->loop = loop;
+        }
+
+        bool isLooping() const {
+            return loop;
+        }
+
+        /* Absolute index of the oldest frame in the window. */
+        uint64_t getStart() const {
+            uint64_t const oldest = history.getPushedCount() - history.size();
+            if (isBounded && !isRecording)
+                return std::max(start, std::min(oldest, pinnedStart));
+            return (isBounded && start > oldest) ? start : oldest;
+        }
+
+        std::size_t size() const {
+            if (isBounded && !isRecording)
+                return end - getStart();
+            return history.getPushedCount() - getStart();
+        }
+
+        frame_ref getFrame(uint64_t index) const {
+            if (index < getStart())
+                return frame_ref();
+            if (isBounded && !isRecording) {
+                if (index >= end)
+                    return frame_ref();
+                return index >= pinnedStart ? pinned[index - pinnedStart] : history.getFrame(index);
+            }
+            return history.getFrame(index);
+        }
+
+        /* Capture rate measured across the frames in the window. */
+        float getFps() const {
+            std::size_t const count = size();
+            uint64_t first, last;
+            if (count < 2 || !getTimestamp(getStart(), first) || !getTimestamp(getStart() + count - 1, last))
+                return 0;
+            return last > first ? (count - 1) * 1000000.0f / (last - first) : 0;
+        }
+
+    private:
+        bool getTimestamp(uint64_t index, uint64_t &timestamp) const {
+            if (isBounded && !isRecording && index >= pinnedStart) {
+                timestamp = pinned[index - pinnedStart]->getTimestamp();
+                return true;
+            }
+            return history.getTimestamp(index, timestamp);
+        }
+
+        void unpin() {
+            history.unpin(pinned.size());
+            pinned.clear();
+        }
+
+        frame_history &history;
+        std::vector<frame_ref> pinned;
+        uint64_t start = 0;
+        uint64_t pinnedStart = 0;
+        uint64_t end = 0;
+        bool isBounded = false;
+        bool isRecording = false;
+        bool loop = true;
+    };
+
+    /*
+     * Playhead over a frame_window. At rest it shows the frame setDelayFrames() frames behind
+     * the newest; playing, it walks the window at its capture rate, looping if the window
+     * does; scrubbing, it sits wherever setFramePosition() last put it. It only converts and
+     * uploads a frame when draw() lands on a different one. With blending on, a fractional
+     * position is drawn as a crossfade of the two frames either side of it. On the programmable
+     * renderer a YUV 4:2:0 frame goes up as its three planes, one single-channel texture each,
+     * and a fragment shader converts it to RGB as it is drawn; otherwise it is converted on the
+     * CPU and uploaded as RGB.
+     */
+    class frame_header {
+    public:
+        void setup(frame_window &window) {
+            this->window = &window;
+        }
+
+        bool isSetup() const {
+            return window != nullptr;
+        }
+
+        void setDelayFrames(float frames) {
+            delayFrames = std::max(frames, 0.0f);
+            isScrubbing = false;
+        }
+
+        float getDelayFrames() const {
+            return delayFrames;
+        }
+
+        void setPlaying(bool playing) {
+            if (playing && !isPlaying && !isCued) {
+                startPlaying(std::floor(getPosition()));
+            }
+            isCued = false;
+            isPlaying = playing;
+            isScrubbing = false;
+        }
+
+        /* Moves the playhead to the start of the window, or cues it there if not playing. */
+        void setLoopToStart() {
+            if (window != nullptr) {
+                startPlaying(window->getStart());
+                isCued = !isPlaying;
+                isScrubbing = false;
+            }
+        }
+
+        /* Holds the playhead at offset frames from the start of the window; fractions blend if setBlending() is on. */
+        void setFramePosition(double offset) {
+            framePosition = offset;
+            isScrubbing = true;
+        }
+
+        void setBlending(bool blending) {
+            isBlending = blending;
+        }
+
+        /* Number of frames in the window being played. */
+        std::size_t getFrameCount() const {
+            return window != nullptr ? window->size() : 0;
+        }
+
+        frame_ref getNextFrame() {
+            if (window == nullptr || window->size() == 0)
+                return frame_ref();
+            return window->getFrame((uint64_t) getPosition());
+        }
+
+        void draw(float x, float y, float w, float h) {
+            if (window == nullptr || window->size() == 0) {
+                drawTextures(x, y, w, h, 0);
+                return;
+            }
+            double const position = getPosition();
+            uint64_t const index = (uint64_t) position;
+            float const blend = isBlending ? (float) (position - index) : 0;
+            frame_ref frame = window->getFrame(index);
+            frame_ref next = blend > 0 ? window->getFrame(index + 1) : frame_ref();
+
+            /* Stepping one frame either way keeps one of the two frames uploaded; swap it into place. */
+            bool const isForwardStep = frame && frame->getSequence() == blendSequence;
+            bool const isBackwardStep = next && next->getSequence() == uploadedSequence;
+            if ((isForwardStep || isBackwardStep) && uploadedSequence != blendSequence) {
+                std::swap(texture, blendTexture);
+                std::swap(uploadedSequence, blendSequence);
+            }
+            if (frame && (frame->getSequence() != uploadedSequence || !texture.isAllocated())) {
+                upload(*frame, texture);
+                uploadedSequence = frame->getSequence();
+            }
+            if (next && (next->getSequence() != blendSequence || !blendTexture.isAllocated())) {
+                upload(*next, blendTexture);
+                blendSequence = next->getSequence();
+            }
+            drawTextures(x, y, w, h, next ? blend : 0);
+        }
+
+        /*
+         * The texture of the last frame drawn. A frame held as planes is converted into an RGB
+         * framebuffer on each call, so the texture keeps that frame while the header moves on.
+         */
+        ofTexture &getTexture() {
+            if (!texture.isPlanar)
+                return texture.packed;
+            ofTexture &luma = texture.planes[0];
+            if (!converted.isAllocated() || converted.getWidth() != luma.getWidth() || converted.getHeight() != luma.getHeight())
+                converted.allocate(luma.getWidth(), luma.getHeight(), GL_RGB);
+            converted.begin();
+            ofPushStyle();
+            ofSetColor(255);
+            drawTexture(texture, 0, 0, luma.getWidth(), luma.getHeight());
+            ofPopStyle();
+            converted.end();
+            return converted.getTexture();
+        }
+
+    private:
+        /* A frame on the GPU: the Y, U and V planes for the shader, or one packed texture. */
+        struct frame_texture {
+            ofTexture packed;
+            ofTexture planes[3];
+            bool isPlanar = false;
+
+            bool isAllocated() const {
+                return isPlanar ? planes[0].isAllocated() : packed.isAllocated();
+            }
+        };
+
+        void upload(const video_frame &frame, frame_texture &target) {
+            const ofPixels &pixels = frame.getPixels();
+            bool const isPlanar = yuv420::isPlanar(pixels.getPixelFormat());
+            target.isPlanar = isPlanar && ofIsGLProgrammableRenderer();
+            if (target.isPlanar) {
+                int const width = pixels.getWidth();
+                int const height = pixels.getHeight();
+                const uint8_t *y = pixels.getData();
+                const uint8_t *u = y + width * height;
+                const uint8_t *v = u + (width / 2) * (height / 2);
+                if (pixels.getPixelFormat() == OF_PIXELS_YV12) {
+                    std::swap(u, v);
+                }
+                uploadPlane(target.planes[0], y, width, height);
+                uploadPlane(target.planes[1], u, width / 2, height / 2);
+                uploadPlane(target.planes[2], v, width / 2, height / 2);
+            } else if (isPlanar) {
+                yuv420::toRgb(pixels, rgb);
+                target.packed.loadData(rgb);
+            } else {
+                target.packed.loadData(pixels);
+            }
+        }
+
+        /* Normalized coordinates, rather than the default rectangle textures', address every plane alike whatever its size. */
+        static void uploadPlane(ofTexture &plane, const uint8_t *data, int width, int height) {
+            if (!plane.isAllocated() || plane.getWidth() != width || plane.getHeight() != height)
+                plane.allocate(width, height, GL_R8, false);
+            plane.loadData(data, width, height, GL_RED);
+        }
+
+        void drawTextures(float x, float y, float w, float h, float blend) {
+            if (!texture.isAllocated())
+                return;
+            drawTexture(texture, x, y, w, h);
+            if (blend > 0 && blendTexture.isAllocated()) {
+                ofPushStyle();
+                ofEnableAlphaBlending();
+                ofSetColor(255, 255, 255, blend * 255);
+                drawTexture(blendTexture, x, y, w, h);
+                ofPopStyle();
+            }
+        }
+
+        static void drawTexture(frame_texture &frame, float x, float y, float w, float h) {
+            if (!frame.isPlanar) {
+                frame.packed.draw(x, y, w, h);
+                return;
+            }
+            ofShader &shader = getShader();
+            shader.begin();
+            shader.setUniformTexture("yPlane", frame.planes[0], 0);
+            shader.setUniformTexture("uPlane", frame.planes[1], 1);
+            shader.setUniformTexture("vPlane", frame.planes[2], 2);
+            frame.planes[0].draw(x, y, w, h);
+            shader.end();
+        }
+
+        /* yuv420::toRgb's BT.601 studio-swing formulas, on normalized samples. */
+        static ofShader &getShader() {
+            static ofShader shader;
+            if (!shader.isLoaded()) {
+                shader.setupShaderFromSource(GL_VERTEX_SHADER,
+                    "#version 150\n"
+                    "uniform mat4 modelViewProjectionMatrix;\n"
+                    "in vec4 position;\n"
+                    "in vec2 texcoord;\n"
+                    "out vec2 texCoordVarying;\n"
+                    "void main() {\n"
+                    "    texCoordVarying = texcoord;\n"
+                    "    gl_Position = modelViewProjectionMatrix * position;\n"
+                    "}\n");
+                shader.setupShaderFromSource(GL_FRAGMENT_SHADER,
+                    "#version 150\n"
+                    "uniform sampler2D yPlane;\n"
+                    "uniform sampler2D uPlane;\n"
+                    "uniform sampler2D vPlane;\n"
+                    "uniform vec4 globalColor;\n"
+                    "in vec2 texCoordVarying;\n"
+                    "out vec4 outputColor;\n"
+                    "void main() {\n"
+                    "    float c = texture(yPlane, texCoordVarying).r - 16.0 / 255.0;\n"
+                    "    float d = texture(uPlane, texCoordVarying).r - 128.0 / 255.0;\n"
+                    "    float e = texture(vPlane, texCoordVarying).r - 128.0 / 255.0;\n"
+                    "    vec3 rgb = vec3(298.0 * c + 409.0 * e, 298.0 * c - 100.0 * d - 208.0 * e, 298.0 * c + 516.0 * d) / 256.0;\n"
+                    "    outputColor = globalColor * vec4(clamp(rgb, 0.0, 1.0), 1.0);\n"
+                    "}\n");
+                shader.bindDefaults();
+                shader.linkProgram();
+            }
+            return shader;
+        }
+
+        void startPlaying(double position) {
+            playStartPosition = position;
+            playStartMicros = ofGetElapsedTimeMicros();
+        }
+
+        /* Absolute index of the frame to show; only a scrubbed position has a fraction. */
+        double getPosition() const {
+            if (window == nullptr || window->size() == 0)
+                return 0;
+            uint64_t const begin = window->getStart();
+            double const length = window->size();
+            if (isScrubbing)
+                return begin + std::min(std::max(framePosition, 0.0), length - 1);
+            if (!isPlaying) {
+                double const delay = std::min<double>(std::round(delayFrames), length - 1);
+                return begin + length - 1 - delay;
+            }
+            double const elapsed = (ofGetElapsedTimeMicros() - playStartMicros) / 1000000.0;
+            double const offset = playStartPosition + elapsed * window->getFps() - begin;
+            if (!window->isLooping())
+                return begin + std::min(std::max(std::floor(offset), 0.0), length - 1);
+            return begin + std::floor(offset - length * std::floor(offset / length));
+        }
+
+        frame_window *window = nullptr;
+        ofPixels rgb;
+        frame_texture texture;
+        frame_texture blendTexture;
+        ofFbo converted;
+        uint64_t uploadedSequence = 0;
+        uint64_t blendSequence = 0;
+        uint64_t playStartMicros = 0;
+        double playStartPosition = 0;
+        double framePosition = 0;
+        float delayFrames = 0;
+        bool isPlaying = false;
+        bool isCued = false;
+        bool isScrubbing = false;
+        bool isBlending = false;
+    };
+}
+
+#endif /* frame_history_h */
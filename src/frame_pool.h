@@ -0,0 +1,226 @@
+#ifndef frame_pool_h
+#define frame_pool_h
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "ofMain.h"
+#include "yuv420.h"
+
+namespace ofxBenG {
+    class frame_pool;
+
+    /* One slot of a frame_pool. Only reachable through a frame_ref. */
+    class video_frame {
+    public:
+        ofPixels &getPixels() {
+            return pixels;
+        }
+
+        const ofPixels &getPixels() const {
+            return pixels;
+        }
+
+        /* Number of the capture that filled this slot; never repeats within a pool. */
+        uint64_t getSequence() const {
+            return sequence;
+        }
+
+        uint64_t getTimestamp() const {
+            return timestamp;
+        }
+
+    private:
+        friend class frame_pool;
+        friend class frame_ref;
+
+        ofPixels pixels;
+        uint64_t sequence = 0;
+        uint64_t timestamp = 0;
+        std::atomic<int> references = {0};
+        frame_pool *pool = nullptr;
+    };
+
+    /* Counted reference to a pooled frame; the slot goes back to its pool when the last one is dropped. */
+    class frame_ref {
+    public:
+        frame_ref() : frame(nullptr) {}
+
+        frame_ref(const frame_ref &other) : frame(other.frame) {
+            retain();
+        }
+
+        frame_ref(frame_ref &&other) : frame(other.frame) {
+            other.frame = nullptr;
+        }
+
+        ~frame_ref() {
+            release();
+        }
+
+        frame_ref &operator=(const frame_ref &other) {
+            if (frame != other.frame) {
+                release();
+                frame = other.frame;
+                retain();
+            }
+            return *this;
+        }
+
+        frame_ref &operator=(frame_ref &&other) {
+            if (this != &other) {
+                release();
+                frame = other.frame;
+                other.frame = nullptr;
+            }
+            return *this;
+        }
+
+        video_frame *operator->() const {
+            return frame;
+        }
+
+        video_frame &operator*() const {
+            return *frame;
+        }
+
+        explicit operator bool() const {
+            return frame != nullptr;
+        }
+
+        void reset() {
+            release();
+            frame = nullptr;
+        }
+
+    private:
+        friend class frame_pool;
+
+        explicit frame_ref(video_frame *frame) : frame(frame) {
+            retain();
+        }
+
+        void retain() {
+            if (frame != nullptr)
+                frame->references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void release();
+
+        video_frame *frame;
+    };
+
+    /*
+     * Fixed set of frame slots shared by everything that records from one stream. A capture
+     * writes the driver's pixels into a free slot once, as planar YUV 4:2:0 when they arrive
+     * packed; windows and headers then pass frame_refs around instead of pixels. Slots are reused most-recently-freed first, so a
+     * slot's pixel storage is allocated the first time it is used and never again while the
+     * format holds. When every slot is in use the capture is dropped rather than allocating.
+     */
+    class frame_pool {
+    public:
+        frame_pool() {}
+
+        ~frame_pool() {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto frame : slots) {
+                if (frame->references.load(std::memory_order_acquire) == 0) {
+                    delete frame;
+                } else {
+                    frame->pool = nullptr; /* the last frame_ref frees it */
+                }
+            }
+        }
+
+        /* Grows the pool to at least capacity slots. */
+        void reserve(std::size_t capacity) {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (slots.size() < capacity) {
+                auto frame = new video_frame;
+                frame->pool = this;
+                slots.push_back(frame);
+                available.push_back(frame);
+            }
+        }
+
+        /* Stores pixels in a free slot. Returns an empty reference if none is free. */
+        frame_ref capture(const ofPixels &pixels, uint64_t timestamp) {
+            video_frame *frame = take();
+            if (frame == nullptr) {
+                droppedCount++;
+                return frame_ref();
+            }
+            yuv420::store(pixels, frame->pixels);
+            frame->sequence = ++captureCount;
+            frame->timestamp = timestamp;
+            return frame_ref(frame);
+        }
+
+        /* A free slot shaped to hold a frame read back from storage, keeping its original sequence; empty if none is free. */
+        frame_ref restore(std::size_t width, std::size_t height, ofPixelFormat format, uint64_t sequence, uint64_t timestamp) {
+            video_frame *frame = take();
+            if (frame == nullptr)
+                return frame_ref();
+            ofPixels &pixels = frame->pixels;
+            if (pixels.getWidth() != width || pixels.getHeight() != height || pixels.getPixelFormat() != format) {
+                pixels.allocate(width, height, format);
+            }
+            frame->sequence = sequence;
+            frame->timestamp = timestamp;
+            return frame_ref(frame);
+        }
+
+        std::size_t getCapacity() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return slots.size();
+        }
+
+        std::size_t getAvailableCount() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return available.size();
+        }
+
+        uint64_t getCaptureCount() const {
+            return captureCount;
+        }
+
+        uint64_t getDroppedCount() const {
+            return droppedCount;
+        }
+
+    private:
+        friend class frame_ref;
+
+        video_frame *take() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (available.empty())
+                return nullptr;
+            video_frame *frame = available.back();
+            available.pop_back();
+            return frame;
+        }
+
+        void recycle(video_frame *frame) {
+            std::lock_guard<std::mutex> lock(mutex);
+            available.push_back(frame);
+        }
+
+        std::mutex mutex;
+        std::vector<video_frame *> slots;
+        std::vector<video_frame *> available;
+        std::atomic<uint64_t> captureCount = {0};
+        std::atomic<uint64_t> droppedCount = {0};
+    };
+
+    void frame_ref::release() {
+        if (frame != nullptr && frame->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (frame->pool != nullptr) {
+                frame->pool->recycle(frame);
+            } else {
+                delete frame;
+            }
+        }
+    }
+}
+
+#endif /* frame_pool_h */
@@ -0,0 +1,355 @@
+#ifndef frame_spill_h
+#define frame_spill_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "frame_codec.h"
+#include "frame_pool.h"
+
+namespace ofxBenG {
+
+    /*
+     * Disk tier behind a frame_history: frames leaving the RAM ring are compressed plane by
+     * plane into fixed-size slots of a memory-mapped file, itself a ring of capacity frames.
+     * Writing happens on its own thread. Reading never blocks the caller: getFrame() hands
+     * back what the read-ahead thread has already decoded around the last requested index,
+     * in the direction playback is moving, and otherwise returns an empty frame_ref and
+     * retargets the read-ahead. A slot being rewritten is detected by checking its index
+     * before and after decoding.
+     */
+    class frame_spill {
+    public:
+        frame_spill(frame_pool &pool, std::size_t capacity, std::size_t readAhead)
+                : pool(pool),
+                  capacity(std::max<std::size_t>(capacity, 1)),
+                  readAhead(readAhead),
+                  entries(new entry[this->capacity]) {}
+
+        ~frame_spill() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                isRunning = false;
+            }
+            writeReady.notify_one();
+            readRequested.notify_one();
+            if (writer.joinable())
+                writer.join();
+            if (reader.joinable())
+                reader.join();
+#ifndef _WIN32
+            if (mapped != nullptr)
+                ::munmap(mapped, capacity * slotBytes);
+            if (fd >= 0)
+                ::close(fd);
+#endif
+        }
+
+        /* Creates the backing file and starts the worker threads. The file is unlinked at once, so it disappears with the process. */
+        bool open(const std::string &file) {
+#ifndef _WIN32
+            fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+            if (fd < 0)
+                return false;
+            ::unlink(file.c_str());
+            isRunning = true;
+            writer = std::thread(&frame_spill::writeLoop, this);
+            reader = std::thread(&frame_spill::readLoop, this);
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /* Pool slots the spill may hold at once: queued writes, the read-ahead cache and the frame being decoded. */
+        std::size_t getPoolSlots() const {
+            return WRITE_QUEUE + 2 * readAhead + 2;
+        }
+
+        std::size_t getCapacity() const {
+            return capacity;
+        }
+
+        /* Queues frame to be stored as index. Drops it if the disk has fallen WRITE_QUEUE frames behind. */
+        void write(frame_ref frame, uint64_t index) {
+            if (!frame)
+                return;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (writes.size() >= WRITE_QUEUE) {
+                    droppedCount++;
+                    return;
+                }
+                writes.emplace_back(std::move(frame), index);
+            }
+            writeReady.notify_one();
+        }
+
+        frame_ref getFrame(uint64_t index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = cache.find(index);
+            if (index != target) {
+                direction = index < target ? -1 : 1;
+                target = index;
+                evictFarFromTarget();
+            } else if (found != cache.end()) {
+                return found->second;
+            }
+            /* Moved, or still missing because it was queued for writing on the last try. */
+            isRequested = true;
+            readRequested.notify_one();
+            return found == cache.end() ? frame_ref() : found->second;
+        }
+
+        bool getTimestamp(uint64_t index, uint64_t &timestamp) const {
+            const entry &e = entries[index % capacity];
+            if (e.index.load(std::memory_order_acquire) != index)
+                return false;
+            timestamp = e.timestamp.load(std::memory_order_relaxed);
+            return e.index.load(std::memory_order_acquire) == index;
+        }
+
+        uint64_t getDroppedCount() const {
+            return droppedCount;
+        }
+
+    private:
+        static std::size_t const WRITE_QUEUE = 16;
+        static std::size_t const PLANES = 3;
+        static uint64_t const EMPTY = ~0ULL;
+
+        struct entry {
+            entry() {
+                for (auto &size : sizes) {
+                    size = 0;
+                }
+            }
+
+            std::atomic<uint64_t> index = {EMPTY};
+            std::atomic<uint64_t> sequence = {0};
+            std::atomic<uint64_t> timestamp = {0};
+            std::atomic<uint32_t> width = {0};
+            std::atomic<uint32_t> height = {0};
+            std::atomic<int> format = {0};
+            std::atomic<uint32_t> sizes[PLANES];
+        };
+
+        /* Byte sizes of the planes of a frame; packed formats are one plane. */
+        static void getPlanes(std::size_t width, std::size_t height, ofPixelFormat format, std::size_t totalBytes, std::size_t (&planes)[PLANES]) {
+            if (yuv420::isPlanar(format)) {
+                planes[0] = width * height;
+                planes[1] = planes[2] = (width / 2) * (height / 2);
+            } else {
+                planes[0] = totalBytes;
+                planes[1] = planes[2] = 0;
+            }
+        }
+
+        void writeLoop() {
+            while (true) {
+                std::pair<frame_ref, uint64_t> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    writeReady.wait(lock, [this]() { return !isRunning || !writes.empty(); });
+                    if (!isRunning)
+                        return;
+                    job = std::move(writes.front());
+                    writes.pop_front();
+                }
+                store(*job.first, job.second);
+            }
+        }
+
+        void store(const video_frame &frame, uint64_t index) {
+            const ofPixels &pixels = frame.getPixels();
+            std::size_t planes[PLANES];
+            getPlanes(pixels.getWidth(), pixels.getHeight(), pixels.getPixelFormat(), pixels.getTotalBytes(), planes);
+            std::size_t bound = 0;
+            for (std::size_t plane : planes) {
+                bound += frame_codec::getBound(plane);
+            }
+            if (!map(bound)) {
+                droppedCount++;
+                return;
+            }
+            if (bound > slotBytes) {
+                if (!isOversizeReported) {
+                    std::cout << "frame_spill: dropping " << pixels.getWidth() << "x" << pixels.getHeight()
+                              << " frames, larger than the first frame the slots were sized for" << std::endl;
+                    isOversizeReported = true;
+                }
+                droppedCount++;
+                return;
+            }
+
+            entry &e = entries[index % capacity];
+            e.index.store(EMPTY, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            uint8_t *out = mapped + (index % capacity) * slotBytes;
+            const uint8_t *in = pixels.getData();
+            for (std::size_t p = 0; p < PLANES; p++) {
+                std::size_t const size = frame_codec::compress(in, planes[p], out, frame_codec::getBound(planes[p]));
+                e.sizes[p].store((uint32_t) size, std::memory_order_relaxed);
+                in += planes[p];
+                out += frame_codec::getBound(planes[p]);
+            }
+            e.width.store((uint32_t) pixels.getWidth(), std::memory_order_relaxed);
+            e.height.store((uint32_t) pixels.getHeight(), std::memory_order_relaxed);
+            e.format.store((int) pixels.getPixelFormat(), std::memory_order_relaxed);
+            e.sequence.store(frame.getSequence(), std::memory_order_relaxed);
+            e.timestamp.store(frame.getTimestamp(), std::memory_order_relaxed);
+            e.index.store(index, std::memory_order_release);
+        }
+
+        /* Sizes the file for slots of the first frame's bound; runs on the writer thread only. */
+        bool map(std::size_t bound) {
+#ifndef _WIN32
+            if (mapped != nullptr)
+                return true;
+            if (isMapFailed)
+                return false;
+            std::size_t const page = (std::size_t) ::sysconf(_SC_PAGESIZE);
+            std::size_t const bytes = (bound + page - 1) / page * page;
+            void *memory = MAP_FAILED;
+            if (::ftruncate(fd, (off_t) (capacity * bytes)) == 0) {
+                memory = ::mmap(nullptr, capacity * bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            if (memory == MAP_FAILED) {
+                isMapFailed = true;
+                return false;
+            }
+            slotBytes = bytes;
+            mapped = static_cast<uint8_t *>(memory);
+            isMapped.store(true, std::memory_order_release);
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void readLoop() {
+            while (true) {
+                uint64_t start;
+                int step;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    readRequested.wait(lock, [this]() { return !isRunning || isRequested; });
+                    if (!isRunning)
+                        return;
+                    isRequested = false;
+                    start = target;
+                    step = direction;
+                }
+
+                for (std::size_t k = 0; k <= readAhead; k++) {
+                    if (step < 0 && k > start)
+                        break;
+                    uint64_t const index = start + step * (int64_t) k;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (isRequested || !isRunning)
+                            break;
+                        if (cache.count(index) > 0)
+                            continue;
+                    }
+                    frame_ref frame = load(index);
+                    if (frame) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        cache[index] = std::move(frame);
+                    }
+                }
+            }
+        }
+
+        frame_ref load(uint64_t index) {
+            if (!isMapped.load(std::memory_order_acquire))
+                return frame_ref();
+            entry &e = entries[index % capacity];
+            if (e.index.load(std::memory_order_acquire) != index)
+                return frame_ref();
+
+            std::size_t const width = e.width.load(std::memory_order_relaxed);
+            std::size_t const height = e.height.load(std::memory_order_relaxed);
+            ofPixelFormat const format = (ofPixelFormat) e.format.load(std::memory_order_relaxed);
+            frame_ref frame = pool.restore(width, height, format, e.sequence.load(std::memory_order_relaxed),
+                                           e.timestamp.load(std::memory_order_relaxed));
+            if (!frame)
+                return frame_ref();
+
+            /* The fields above may be torn by a concurrent store; never let them walk decoding out of the slot. */
+            ofPixels &pixels = frame->getPixels();
+            std::size_t planes[PLANES];
+            getPlanes(width, height, format, pixels.getTotalBytes(), planes);
+            std::size_t bound = 0;
+            for (std::size_t plane : planes) {
+                bound += frame_codec::getBound(plane);
+            }
+            if (bound > slotBytes)
+                return frame_ref();
+            const uint8_t *in = mapped + (index % capacity) * slotBytes;
+            uint8_t *out = pixels.getData();
+            for (std::size_t p = 0; p < PLANES; p++) {
+                std::size_t const size = e.sizes[p].load(std::memory_order_relaxed);
+                if (size > frame_codec::getBound(planes[p]) || !frame_codec::decompress(in, size, out, planes[p]))
+                    return frame_ref();
+                in += frame_codec::getBound(planes[p]);
+                out += planes[p];
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return e.index.load(std::memory_order_relaxed) == index ? frame : frame_ref();
+        }
+
+        /* Keeps only frames within readAhead of the target; called with the mutex held. */
+        void evictFarFromTarget() {
+            for (auto it = cache.begin(); it != cache.end();) {
+                uint64_t const distance = it->first > target ? it->first - target : target - it->first;
+                if (distance > readAhead) {
+                    it = cache.erase(it);
+                } else {
+                    it++;
+                }
+            }
+        }
+
+        frame_pool &pool;
+        std::size_t const capacity;
+        std::size_t const readAhead;
+        std::unique_ptr<entry[]> entries;
+
+        std::mutex mutex;
+        std::condition_variable writeReady;
+        std::condition_variable readRequested;
+        std::deque<std::pair<frame_ref, uint64_t>> writes;
+        std::map<uint64_t, frame_ref> cache;
+        uint64_t target = 0;
+        int direction = 1;
+        bool isRequested = false;
+        bool isRunning = false;
+        std::thread writer;
+        std::thread reader;
+
+        int fd = -1;
+        uint8_t *mapped = nullptr;
+        std::size_t slotBytes = 0;
+        std::atomic<bool> isMapped = {false};
+        bool isMapFailed = false;
+        bool isOversizeReported = false;
+        std::atomic<uint64_t> droppedCount = {0};
+    };
+}
+
+#endif /* frame_spill_h */
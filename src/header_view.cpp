@@ -6,19 +6,16 @@
 
 using namespace ofxBenG;
 
-header_view::header_view(ofxPm::VideoHeader *header) {
-    renderer = new ofxPm::BasicVideoRenderer;
-    renderer->setup(*header);
+header_view::header_view(ofxBenG::frame_header *header) : header(header) {
 }
 
 header_view::~header_view() {
-    delete renderer;
 }
 
 void header_view::draw(ofPoint windowSize) {
-    renderer->draw(0, 0, windowSize[0], windowSize[1]);
+    header->draw(0, 0, windowSize[0], windowSize[1]);
 }
 
 void header_view::draw(float x, float y, float w, float h) {
-    renderer->draw(x, y, w, h);
+    header->draw(x, y, w, h);
 }
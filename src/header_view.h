@@ -6,20 +6,19 @@
 #define PLUGANDPLAYCAM_HEADER_VIEW_H
 
 #include <ofPoint.h>
-#include "BasicVideoRenderer.h"
-#include "VideoHeader.h"
+#include "frame_history.h"
 #include "window_view.h"
 
 namespace ofxBenG {
     class header_view : public window_view {
     public:
-        header_view(ofxPm::VideoHeader *header);
+        header_view(ofxBenG::frame_header *header);
         ~header_view();
         void draw(ofPoint windowSize);
         void draw(float x, float y, float w, float h);
 
     private:
-        ofxPm::BasicVideoRenderer *renderer;
+        ofxBenG::frame_header *header;
     };
 }
 
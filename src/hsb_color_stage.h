@@ -0,0 +1,224 @@
+#ifndef hsb_color_stage_h
+#define hsb_color_stage_h
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "tracer.h"
+
+namespace ofxBenG {
+
+/*
+ * One draw strategy that does the work of StrokeColor plus Hue, Saturation, Brightness,
+ * InvertHue and PerlinBrightness, without writing the intermediate colors back to the
+ * stroke. Hue, saturation and brightness stay floats through every adjustment and are
+ * converted to RGB once at the end. The separate stages round to 8-bit channels after each
+ * one, so the results can differ by a color step for each rounding after the first, and by
+ * more where the chain passed through a much darker or greyer color. Like those stages, a
+ * black color loses its hue and saturation and a grey one its hue. The batch form gathers
+ * every PerlinBrightness lookup into one noise_batch pass and the HSB to RGB step into one
+ * vectorizable loop.
+ */
+class hsb_color_stage : public TracerDrawStrategy {
+public:
+    hsb_color_stage(StrokeColor* stroke) : stroke(stroke) {}
+
+    hsb_color_stage& setHue(property<int>& hue) {
+        this->hue.reset(new property<int>("hue", hue));
+        return *this;
+    }
+
+    hsb_color_stage& setSaturation(property<int>& saturation) {
+        this->saturation.reset(new property<int>("saturation", saturation));
+        return *this;
+    }
+
+    hsb_color_stage& setBrightness(property<int>& brightness) {
+        this->brightness.reset(new property<int>("brightness", brightness));
+        return *this;
+    }
+
+    hsb_color_stage& setInvertHue(bool invertHue) {
+        this->invertHue = invertHue;
+        return *this;
+    }
+
+    hsb_color_stage& setPerlinBrightness(ofVec3f timeShift, ofVec3f velocity) {
+        this->isPerlinBrightness = true;
+        this->timeShift = timeShift;
+        this->velocity = velocity;
+        return *this;
+    }
+
+    void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
+        if (!isAdjusting()) {
+            t->path.setStrokeColor(stroke->getColor());
+            return;
+        }
+        ofColor const color = stroke->getColor();
+        float h, s, b, red, green, blue;
+        adjust(color, h, s, b);
+        if (isPerlinBrightness) {
+            b = getPerlinBrightness(noise_batch::noise(getNoiseInput(time)));
+        }
+        toRgb(&h, &s, &b, &red, &green, &blue, 1);
+        t->path.setStrokeColor(ofColor(red, green, blue, color.a));
+    }
+
+    /* Colors tracers[i] with stages[i]. Scratch space is kept by the first stage, so repeated draws don't allocate. */
+    static void draw(const std::vector<hsb_color_stage*>& stages, const std::vector<Tracer*>& tracers, float time) {
+        std::size_t const count = std::min(stages.size(), tracers.size());
+        if (count == 0)
+            return;
+        scratch& work = stages.front()->work;
+        work.clear();
+        work.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            work.colors[i] = stages[i]->stroke->getColor();
+            work.isAdjusted[i] = stages[i]->isAdjusting();
+            stages[i]->adjust(work.colors[i], work.h[i], work.s[i], work.b[i]);
+            if (stages[i]->isPerlinBrightness) {
+                work.perlin.push_back(i);
+                work.noise.add(stages[i]->getNoiseInput(time));
+            }
+        }
+        work.noise.evaluate();
+        for (std::size_t k = 0; k < work.perlin.size(); k++) {
+            work.b[work.perlin[k]] = getPerlinBrightness(work.noise[k]);
+        }
+
+        toRgb(work.h.data(), work.s.data(), work.b.data(), work.red.data(), work.green.data(), work.blue.data(), count);
+        for (std::size_t i = 0; i < count; i++) {
+            ofColor const color = work.colors[i];
+            tracers[i]->path.setStrokeColor(work.isAdjusted[i] ? ofColor(work.red[i], work.green[i], work.blue[i], color.a) : color);
+        }
+    }
+
+private:
+    struct scratch {
+        void clear() {
+            perlin.clear();
+            noise.clear();
+        }
+
+        void resize(std::size_t count) {
+            colors.resize(count);
+            isAdjusted.resize(count);
+            h.resize(count);
+            s.resize(count);
+            b.resize(count);
+            red.resize(count);
+            green.resize(count);
+            blue.resize(count);
+        }
+
+        std::vector<ofColor> colors;
+        std::vector<unsigned char> isAdjusted;
+        std::vector<std::size_t> perlin;
+        noise_batch noise;
+        std::vector<float> h, s, b;
+        std::vector<float> red, green, blue;
+    };
+
+    /* Without adjustments the stroke color passes through as is, rather than round-tripping through HSB. */
+    bool isAdjusting() const {
+        return hue || saturation || brightness || invertHue || isPerlinBrightness;
+    }
+
+    /* color in HSB after Hue, Saturation, Brightness and InvertHue, in the order the separate stages run. */
+    void adjust(const ofColor& color, float& h, float& s, float& b) {
+        color.getHsb(h, s, b);
+        if (hue) {
+            hue->clean();
+            h = *hue;
+            settle(h, s, b);
+        }
+        if (saturation) {
+            saturation->clean();
+            s = *saturation;
+            settle(h, s, b);
+        }
+        if (brightness) {
+            brightness->clean();
+            b = *brightness;
+            settle(h, s, b);
+        }
+        if (invertHue) {
+            h = ofColor::limit() - h;
+            settle(h, s, b);
+        }
+    }
+
+    /* What ofColor::setHsb() and getHsb() keep of a color: channels are clamped, black has no hue or saturation and grey has no hue. */
+    static void settle(float& h, float& s, float& b) {
+        float const limit = ofColor::limit();
+        s = std::min(std::max(s, 0.0f), limit);
+        b = std::min(std::max(b, 0.0f), limit);
+        s = b == 0 ? 0 : s;
+        h = s == 0 ? 0 : h;
+    }
+
+    float getNoiseInput(float time) const {
+        return time * velocity[0] + timeShift[0];
+    }
+
+    static float getPerlinBrightness(float noise) {
+        return ofMap(noise, 0, 1, 0, ofColor::limit(), true);
+    }
+
+    /*
+     * ofColor::setHsb() with the same arithmetic, written as selects so the loop vectorizes.
+     * The channels come out as floats and truncate like setHsb()'s when stored in an ofColor.
+     * Inputs have been through settle() or a clamped ofMap(), so they are in range and the
+     * hue is never negative.
+     */
+    static void toRgb(const float* __restrict h, const float* __restrict s, const float* __restrict b,
+                      float* __restrict red, float* __restrict green, float* __restrict blue, std::size_t count) {
+        float const limit = ofColor::limit();
+        for (std::size_t i = 0; i < count; i++) {
+            float const saturation = s[i] / limit;
+            float const brightness = b[i];
+            float const hueSix = h[i] * 6.0f / limit;
+            float const sector = (float) (int) hueSix;
+            float const remainder = hueSix - sector;
+            float const p = (1.0f - saturation) * brightness;
+            float const q = (1.0f - saturation * remainder) * brightness;
+            float const t = (1.0f - saturation * (1.0f - remainder)) * brightness;
+            float r = brightness;
+            r = sector == 1.0f ? q : r;
+            r = sector == 2.0f ? p : r;
+            r = sector == 3.0f ? p : r;
+            r = sector == 4.0f ? t : r;
+            float g = p;
+            g = sector == 0.0f ? t : g;
+            g = sector == 6.0f ? t : g;
+            g = sector == 1.0f ? brightness : g;
+            g = sector == 2.0f ? brightness : g;
+            g = sector == 3.0f ? q : g;
+            float bl = brightness;
+            bl = sector == 0.0f ? p : bl;
+            bl = sector == 6.0f ? p : bl;
+            bl = sector == 1.0f ? p : bl;
+            bl = sector == 2.0f ? t : bl;
+            bl = sector == 5.0f ? q : bl;
+            red[i] = r;
+            green[i] = g;
+            blue[i] = bl;
+        }
+    }
+
+    StrokeColor* stroke;
+    std::unique_ptr<property<int>> hue;
+    std::unique_ptr<property<int>> saturation;
+    std::unique_ptr<property<int>> brightness;
+    bool invertHue = false;
+    bool isPerlinBrightness = false;
+    ofVec3f timeShift;
+    ofVec3f velocity;
+    scratch work;
+};
+
+} // ofxBenG
+
+#endif /* hsb_color_stage_h */
@@ -0,0 +1,171 @@
+#ifndef inplace_function_h
+#define inplace_function_h
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ofxBenG {
+
+    template <typename Signature, std::size_t Capacity = 64>
+    class inplace_function;
+
+    /*
+     * std::function replacement that stores callables of up to Capacity bytes in an inline
+     * buffer, so wrapping a typical lambda never touches the heap. Larger or over-aligned
+     * callables still work but are boxed on the heap, one allocation each, like
+     * std::function would; keep captures small on hot paths.
+     */
+    template <typename R, typename... Args, std::size_t Capacity>
+    class inplace_function<R(Args...), Capacity> {
+    public:
+        inplace_function() {
+        }
+
+        inplace_function(std::nullptr_t) {
+        }
+
+        template <typename F,
+                  typename Callable = typename std::decay<F>::type,
+                  typename = typename std::enable_if<!std::is_same<Callable, inplace_function>::value>::type,
+                  typename = decltype(std::declval<Callable &>()(std::declval<Args>()...))>
+        inplace_function(F &&f) {
+            store<Callable>(std::forward<F>(f), fits_inline<Callable>());
+        }
+
+        inplace_function(const inplace_function &other) {
+            copyFrom(other);
+        }
+
+        inplace_function(inplace_function &&other) {
+            moveFrom(other);
+        }
+
+        ~inplace_function() {
+            reset();
+        }
+
+        inplace_function &operator=(const inplace_function &other) {
+            if (this != &other) {
+                reset();
+                copyFrom(other);
+            }
+            return *this;
+        }
+
+        inplace_function &operator=(inplace_function &&other) {
+            if (this != &other) {
+                reset();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        R operator()(Args... args) const {
+            return invoker(const_cast<void *>(static_cast<const void *>(&storage)), std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const {
+            return invoker != nullptr;
+        }
+
+    private:
+        enum operation {
+            COPY, MOVE, DESTROY
+        };
+
+        typedef R (*invoker_t)(void *, Args &&...);
+        typedef void (*manager_t)(operation, void *, void *);
+
+        template <typename Callable>
+        struct fits_inline : std::integral_constant<bool, sizeof(Callable) <= Capacity && alignof(Callable) <= alignof(std::max_align_t)> {
+        };
+
+        template <typename Callable, typename F>
+        void store(F &&f, std::true_type) {
+            new (&storage) Callable(std::forward<F>(f));
+            invoker = &invoke<Callable>;
+            manager = &manage<Callable>;
+        }
+
+        /* The buffer holds a pointer to the boxed callable instead. */
+        template <typename Callable, typename F>
+        void store(F &&f, std::false_type) {
+            new (&storage) Callable *(new Callable(std::forward<F>(f)));
+            invoker = &invokeBoxed<Callable>;
+            manager = &manageBoxed<Callable>;
+        }
+
+        template <typename Callable>
+        static R invoke(void *callable, Args &&... args) {
+            return (*static_cast<Callable *>(callable))(std::forward<Args>(args)...);
+        }
+
+        template <typename Callable>
+        static void manage(operation op, void *destination, void *source) {
+            switch (op) {
+                case COPY:
+                    new (destination) Callable(*static_cast<const Callable *>(source));
+                    break;
+                case MOVE:
+                    new (destination) Callable(std::move(*static_cast<Callable *>(source)));
+                    static_cast<Callable *>(source)->~Callable();
+                    break;
+                case DESTROY:
+                    static_cast<Callable *>(destination)->~Callable();
+                    break;
+            }
+        }
+
+        template <typename Callable>
+        static R invokeBoxed(void *box, Args &&... args) {
+            return (**static_cast<Callable **>(box))(std::forward<Args>(args)...);
+        }
+
+        template <typename Callable>
+        static void manageBoxed(operation op, void *destination, void *source) {
+            switch (op) {
+                case COPY:
+                    new (destination) Callable *(new Callable(**static_cast<Callable *const *>(source)));
+                    break;
+                case MOVE:
+                    new (destination) Callable *(*static_cast<Callable **>(source));
+                    break;
+                case DESTROY:
+                    delete *static_cast<Callable **>(destination);
+                    break;
+            }
+        }
+
+        void copyFrom(const inplace_function &other) {
+            if (other.manager != nullptr)
+                other.manager(COPY, &storage, const_cast<void *>(static_cast<const void *>(&other.storage)));
+            invoker = other.invoker;
+            manager = other.manager;
+        }
+
+        void moveFrom(inplace_function &other) {
+            if (other.manager != nullptr)
+                other.manager(MOVE, &storage, &other.storage);
+            invoker = other.invoker;
+            manager = other.manager;
+            other.invoker = nullptr;
+            other.manager = nullptr;
+        }
+
+        void reset() {
+            if (manager != nullptr)
+                manager(DESTROY, &storage, nullptr);
+            invoker = nullptr;
+            manager = nullptr;
+        }
+
+        typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type storage;
+        invoker_t invoker = nullptr;
+        manager_t manager = nullptr;
+    };
+
+} // ofxBenG
+
+#endif /* inplace_function_h */
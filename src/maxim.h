@@ -5,6 +5,10 @@
 #include "audio.h"
 
 namespace ofxBenG {
+    /*
+     * The loop itself runs on the audio thread, which shares it with the stutter. Deleting the
+     * stutter early retires the loop: it plays out and the audio thread hands it back.
+     */
     class maxim_stutter {
     public:
         maxim_stutter(ofxMaxiSample* sample, float triggerSeconds, float lengthSeconds, int times)
@@ -14,11 +18,28 @@ namespace ofxBenG {
             endPercent = MIN(1, triggerSeconds / sampleLengthSeconds);
             startPercent = MAX(0, endPercent - lengthPercent);
             std::cout << "new stutter @seconds=" << triggerSeconds << " {times=" << times << ", start=" << startPercent << ", end=" << endPercent << "}" << std::endl;
+            loop = new sample_loop();
+            loop->sample = sample;
+            loop->startPercent = startPercent;
+            loop->endPercent = endPercent;
+            loop->remaining.store(times);
+            if (times <= 0) {
+                loop->holders.fetch_sub(1, std::memory_order_relaxed);
+            } else if (!ofxBenG::audio::getInstance()->cue(audio_cue::loopSample(loop))) {
+                loop->remaining.store(0);
+            }
         }
 
         maxim_stutter(ofxMaxiSample* sample, float lengthSeconds, int times)
         : maxim_stutter(sample, sample->getPositionSeconds(), lengthSeconds, times) {}
 
+        maxim_stutter(const maxim_stutter&) = delete;
+        void operator=(const maxim_stutter&) = delete;
+
+        ~maxim_stutter() {
+            ofxBenG::audio::getInstance()->retire(loop);
+        }
+
         static maxim_stutter* make_random(ofxMaxiSample* sample) {
             float const currentSeconds = sample->getPositionSeconds();
             std::cout << "stutter, sampleCurrentSeconds=" << currentSeconds << std::endl;
@@ -29,22 +50,17 @@ namespace ofxBenG {
         }
 
         bool isDone() {
-            return times <= 0;
+            return loop->remaining.load(std::memory_order_acquire) <= 0;
         }
 
-        void update() {
-            if (sample->getPosition() >= endPercent) {
-                std::cout << "stutter, sampleCurrentSeconds=" << sample->getPositionSeconds() << ", times=" << times << ", position=" << sample->getPosition() << std::endl;
-                sample->setPosition(startPercent);
-                times--;
-            }
-        }
+        void update() {}
 
     private:
         ofxMaxiSample* sample;
         float startPercent;
         float endPercent;
         int times;
+        sample_loop *loop;
         static float constexpr minimumSecondsBetweenStutters = 8;
         static float constexpr maximumSecondsBetweenStutters = 16;
         static float constexpr minimumLengthSeconds = 1.0 / 8.0;
@@ -53,38 +69,47 @@ namespace ofxBenG {
         static int constexpr maxTimes = 8;
     };
 
+    /* Pending cues point at the reverse, so like a stutter's loop it is shared with the audio thread and retired on deletion. */
     class maxim_reverse {
     public:
         maxim_reverse(ofxMaxiSample* forwardSample, ofxMaxiSample* backwardSample, float lengthSeconds)
-                : forwardSample(forwardSample), backwardSample(backwardSample), lengthSeconds(lengthSeconds) {
-            backwardSample->setPosition(1 - forwardSample->getPosition());
-            forwardSample->setPositionSeconds(forwardSample->getPositionSeconds() - lengthSeconds);
-            targetSeconds = backwardSample->getPositionSeconds() + lengthSeconds;
-            ofxBenG::audio::getInstance()->setSample(backwardSample);
-            std::cout << "reverse, seconds=" << lengthSeconds << std::endl;
-        }
+                : maxim_reverse(forwardSample, backwardSample, lengthSeconds, audio_cue::IMMEDIATELY) {}
 
-        ~maxim_reverse() {
-            std::cout << "reverse, set current sample = forwardSample" << std::endl;
-            ofxBenG::audio::getInstance()->setSample(forwardSample);
-        }
+        /* Starts on startBeat of clock's timeline, so the turn lands on the beat rather than on the next render frame. */
+        maxim_reverse(ofxMaxiSample* forwardSample, ofxMaxiSample* backwardSample, float lengthSeconds, float startBeat, const frame_clock& clock)
+                : maxim_reverse(forwardSample, backwardSample, lengthSeconds, clock.microsecondsAtBeat(startBeat)) {}
 
         static maxim_reverse* make_random(ofxMaxiSample* forwardSample, ofxMaxiSample* backwardSample) {
             float lengthSeconds = ofRandom(5);
             return new maxim_reverse(forwardSample, backwardSample, lengthSeconds);
         }
 
+        maxim_reverse(const maxim_reverse&) = delete;
+        void operator=(const maxim_reverse&) = delete;
+
+        ~maxim_reverse() {
+            ofxBenG::audio::getInstance()->retire(reverse);
+        }
+
         bool isDone() {
-            return backwardSample->getPositionSeconds() >= targetSeconds;
+            return reverse->state.load(std::memory_order_acquire) == sample_reverse::DONE;
         }
 
         void update() {}
 
     private:
-        ofxMaxiSample* forwardSample;
-        ofxMaxiSample* backwardSample;
-        float lengthSeconds;
-        float targetSeconds;
+        maxim_reverse(ofxMaxiSample* forwardSample, ofxMaxiSample* backwardSample, float lengthSeconds, uint64_t startMicroseconds) {
+            reverse = new sample_reverse();
+            reverse->forward = forwardSample;
+            reverse->backward = backwardSample;
+            reverse->lengthSeconds = lengthSeconds;
+            reverse->state.store(sample_reverse::WAITING);
+            std::cout << "reverse, seconds=" << lengthSeconds << std::endl;
+            if (!ofxBenG::audio::getInstance()->cue(audio_cue::reverseSample(reverse, startMicroseconds)))
+                reverse->state.store(sample_reverse::DONE);
+        }
+
+        sample_reverse *reverse;
     };
 };
 
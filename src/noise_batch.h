@@ -0,0 +1,105 @@
+#ifndef noise_batch_h
+#define noise_batch_h
+
+#include <cstddef>
+#include <vector>
+
+namespace ofxBenG {
+
+/*
+ * Batched 1D simplex noise that returns exactly what ofNoise(float) returns. Callers add
+ * every lookup for the frame, evaluate() runs them all in one branch-free loop, and results
+ * are read back by the index add() returned.
+ */
+class noise_batch {
+public:
+    std::size_t add(float x) {
+        inputs.push_back(x);
+        return inputs.size() - 1;
+    }
+
+    void evaluate() {
+        outputs.resize(inputs.size());
+        noise(inputs.data(), outputs.data(), inputs.size());
+    }
+
+    float operator[](std::size_t i) const {
+        return outputs[i];
+    }
+
+    std::size_t size() const {
+        return inputs.size();
+    }
+
+    void clear() {
+        inputs.clear();
+        outputs.clear();
+    }
+
+    /* Same arithmetic as _slang_library_noise1() behind ofNoise(), with the permutation and gradient folded into one table. */
+    static void noise(const float* __restrict x, float* __restrict out, std::size_t count) {
+        const float* __restrict gradients = getGradients();
+        for (std::size_t i = 0; i < count; i++) {
+            float const xi = x[i];
+            int const i0 = (int) xi - (xi > 0.0f ? 0 : 1);
+            float const x0 = xi - (float) i0;
+            float const x1 = x0 - 1.0f;
+            float t0 = 1.0f - x0 * x0;
+            float t1 = 1.0f - x1 * x1;
+            t0 *= t0;
+            t1 *= t1;
+            float const n0 = t0 * t0 * (gradients[i0 & 0xff] * x0);
+            float const n1 = t1 * t1 * (gradients[(i0 + 1) & 0xff] * x1);
+            out[i] = 0.25f * (n0 + n1) * 0.5f + 0.5f;
+        }
+    }
+
+    static float noise(float x) {
+        float out;
+        noise(&x, &out, 1);
+        return out;
+    }
+
+private:
+    static const float* getGradients() {
+        static gradient_table table;
+        return table.gradients;
+    }
+
+    struct gradient_table {
+        gradient_table() {
+            static unsigned char const perm[256] = {
+            151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+            140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+            247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+            57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+            74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+            60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+            65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+            200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+            52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+            207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+            119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+            129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+            218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+            81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+            184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+            222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180
+            };
+            for (int i = 0; i < 256; i++) {
+                int const h = perm[i] & 15;
+                float const grad = 1.0f + (h & 7);
+                gradients[i] = (h & 8) ? -grad : grad;
+            }
+        }
+
+        float gradients[256];
+    };
+
+    std::vector<float> inputs;
+    std::vector<float> outputs;
+};
+
+} // ofxBenG
+
+#endif /* noise_batch_h */
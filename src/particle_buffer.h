@@ -0,0 +1,364 @@
+#ifndef particle_buffer_h
+#define particle_buffer_h
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ofMain.h"
+
+namespace ofxBenG {
+
+class Particle {
+public:
+    Particle(ofVec3f location, ofVec3f velocity = ofVec3f::zero(), float mass = 0) {
+        this->location = location;
+        this->velocity = velocity;
+        this->mass = mass;
+    }
+
+    void applyForce(ofVec3f force) {
+        force /= mass;
+        acceleration += force;
+    }
+
+    void update() {
+        velocity += acceleration;
+        location += velocity;
+        acceleration *= 0;
+    }
+
+    void setLocation(ofVec3f location) {
+        this->location = location;
+    }
+
+    ofVec3f location;
+    ofVec3f velocity;
+    ofVec3f acceleration;
+    float mass;
+};
+
+class particle_buffer;
+
+/*
+ * Handle to one particle inside a particle_buffer. It compares to nullptr like the old
+ * Particle pointers did, and -> yields a Particle snapshot for reads, gathered from the
+ * buffer only when -> is used; writes go through the setters.
+ */
+class particle_ref {
+public:
+    particle_ref() : buffer(nullptr), index(0), snapshot(ofVec3f::zero()) {}
+    particle_ref(particle_buffer* buffer, std::size_t index);
+
+    ofVec3f getLocation() const;
+    void setLocation(ofVec3f location);
+    ofVec3f getVelocity() const;
+    ofVec3f getAcceleration() const;
+    float getMass() const;
+    void applyForce(ofVec3f force);
+
+    const Particle* operator->() const {
+        snapshot.location = getLocation();
+        snapshot.velocity = getVelocity();
+        snapshot.acceleration = getAcceleration();
+        snapshot.mass = getMass();
+        return &snapshot;
+    }
+
+    bool operator==(std::nullptr_t) const {
+        return buffer == nullptr;
+    }
+
+    bool operator!=(std::nullptr_t) const {
+        return buffer != nullptr;
+    }
+
+    explicit operator bool() const {
+        return buffer != nullptr;
+    }
+
+private:
+    particle_buffer* buffer;
+    std::size_t index;
+    mutable Particle snapshot;
+};
+
+/*
+ * Structure-of-arrays ring of particles. Each component lives in its own contiguous array
+ * so integrate() runs as straight vectorizable loops, and appending at the head or
+ * trimming the tail never allocates once the ring has grown to the trail length.
+ */
+class particle_buffer {
+public:
+    class iterator {
+    public:
+        iterator(particle_buffer* buffer, std::size_t index) : buffer(buffer), index(index) {}
+
+        particle_ref operator*() const {
+            return particle_ref(buffer, index);
+        }
+
+        iterator& operator++() {
+            index++;
+            return *this;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return index != other.index;
+        }
+
+    private:
+        particle_buffer* buffer;
+        std::size_t index;
+    };
+
+    std::size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void push_back(ofVec3f location, ofVec3f velocity = ofVec3f::zero(), float mass = 0) {
+        if (count == capacity)
+            grow();
+        std::size_t const i = physical(count);
+        x[i] = location.x;
+        y[i] = location.y;
+        z[i] = location.z;
+        vx[i] = velocity.x;
+        vy[i] = velocity.y;
+        vz[i] = velocity.z;
+        ax[i] = 0;
+        ay[i] = 0;
+        az[i] = 0;
+        m[i] = mass;
+        if (velocity != ofVec3f::zero())
+            isMoving = true;
+        count++;
+        pushed++;
+    }
+
+    void pop_front() {
+        if (count == 0)
+            return;
+        start = (start + 1) & (capacity - 1);
+        count--;
+        popped++;
+        if (forcedEnd > 0) {
+            forcedEnd--;
+            if (forcedBegin > 0)
+                forcedBegin--;
+        }
+    }
+
+    void clear() {
+        popped += count;
+        start = 0;
+        count = 0;
+        forcedBegin = 0;
+        forcedEnd = 0;
+        isMoving = false;
+    }
+
+    particle_ref operator[](std::size_t i) {
+        return particle_ref(this, i);
+    }
+
+    particle_ref front() {
+        return empty() ? particle_ref() : particle_ref(this, 0);
+    }
+
+    particle_ref back() {
+        return empty() ? particle_ref() : particle_ref(this, count - 1);
+    }
+
+    iterator begin() {
+        return iterator(this, 0);
+    }
+
+    iterator end() {
+        return iterator(this, count);
+    }
+
+    ofVec3f getLocation(std::size_t i) const {
+        std::size_t const p = physical(i);
+        return ofVec3f(x[p], y[p], z[p]);
+    }
+
+    void setLocation(std::size_t i, ofVec3f location) {
+        std::size_t const p = physical(i);
+        x[p] = location.x;
+        y[p] = location.y;
+        z[p] = location.z;
+        moved++;
+    }
+
+    ofVec3f getVelocity(std::size_t i) const {
+        std::size_t const p = physical(i);
+        return ofVec3f(vx[p], vy[p], vz[p]);
+    }
+
+    ofVec3f getAcceleration(std::size_t i) const {
+        std::size_t const p = physical(i);
+        return ofVec3f(ax[p], ay[p], az[p]);
+    }
+
+    float getMass(std::size_t i) const {
+        return m[physical(i)];
+    }
+
+    void applyForce(std::size_t i, ofVec3f force) {
+        std::size_t const p = physical(i);
+        ax[p] += force.x / m[p];
+        ay[p] += force.y / m[p];
+        az[p] += force.z / m[p];
+        if (forcedBegin == forcedEnd) {
+            forcedBegin = i;
+            forcedEnd = i + 1;
+        } else {
+            forcedBegin = std::min(forcedBegin, i);
+            forcedEnd = std::max(forcedEnd, i + 1);
+        }
+    }
+
+    /*
+     * Same step as Particle::update(). Acceleration is only nonzero where a force was applied
+     * since the last step, so velocity is updated over that range alone; positions move in
+     * one pass over the ring's two contiguous spans. A ring that has never had a velocity or
+     * a force, such as a trail grown by HeadGrowth, is left alone and does not count as moved.
+     */
+    void integrate() {
+        if (count == 0)
+            return;
+        if (forcedBegin != forcedEnd)
+            isMoving = true;
+        for (std::size_t i = forcedBegin; i < forcedEnd; i++) {
+            std::size_t const p = physical(i);
+            vx[p] += ax[p];
+            vy[p] += ay[p];
+            vz[p] += az[p];
+            ax[p] = 0;
+            ay[p] = 0;
+            az[p] = 0;
+        }
+        forcedBegin = 0;
+        forcedEnd = 0;
+        if (!isMoving)
+            return;
+
+        std::size_t const firstLength = std::min(count, capacity - start);
+        integrateSpan(start, firstLength);
+        integrateSpan(0, count - firstLength);
+        moved++;
+    }
+
+    /* Total particles ever appended and trimmed; lets incremental consumers tell what changed since they last looked. */
+    uint64_t getPushedCount() const {
+        return pushed;
+    }
+
+    uint64_t getPoppedCount() const {
+        return popped;
+    }
+
+    /* Bumped whenever particles already in the buffer move, by setLocation() or integrate(). */
+    uint64_t getMovedCount() const {
+        return moved;
+    }
+
+private:
+    std::size_t physical(std::size_t i) const {
+        return (start + i) & (capacity - 1);
+    }
+
+    void integrateSpan(std::size_t first, std::size_t length) {
+        float* __restrict px = x.data() + first;
+        float* __restrict py = y.data() + first;
+        float* __restrict pz = z.data() + first;
+        const float* __restrict pvx = vx.data() + first;
+        const float* __restrict pvy = vy.data() + first;
+        const float* __restrict pvz = vz.data() + first;
+        for (std::size_t i = 0; i < length; i++) {
+            px[i] += pvx[i];
+            py[i] += pvy[i];
+            pz[i] += pvz[i];
+        }
+    }
+
+    void grow() {
+        std::size_t const newCapacity = (capacity == 0) ? initialCapacity : capacity * 2;
+        unwrap(x, newCapacity);
+        unwrap(y, newCapacity);
+        unwrap(z, newCapacity);
+        unwrap(vx, newCapacity);
+        unwrap(vy, newCapacity);
+        unwrap(vz, newCapacity);
+        unwrap(ax, newCapacity);
+        unwrap(ay, newCapacity);
+        unwrap(az, newCapacity);
+        unwrap(m, newCapacity);
+        start = 0;
+        capacity = newCapacity;
+    }
+
+    void unwrap(std::vector<float>& component, std::size_t newCapacity) {
+        std::vector<float> grown(newCapacity);
+        for (std::size_t i = 0; i < count; i++) {
+            grown[i] = component[physical(i)];
+        }
+        component.swap(grown);
+    }
+
+    static std::size_t const initialCapacity = 64;
+
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> ax, ay, az;
+    std::vector<float> m;
+    std::size_t start = 0;
+    std::size_t count = 0;
+    std::size_t capacity = 0;
+    /* Logical range of particles with a force applied since the last integrate(). */
+    std::size_t forcedBegin = 0;
+    std::size_t forcedEnd = 0;
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t moved = 0;
+    /* Set once any particle has had a velocity or a force; cleared by clear(). */
+    bool isMoving = false;
+};
+
+inline particle_ref::particle_ref(particle_buffer* buffer, std::size_t index)
+    : buffer(buffer),
+      index(index),
+      snapshot(ofVec3f::zero()) {}
+
+inline ofVec3f particle_ref::getLocation() const {
+    return buffer->getLocation(index);
+}
+
+inline void particle_ref::setLocation(ofVec3f location) {
+    buffer->setLocation(index, location);
+}
+
+inline ofVec3f particle_ref::getVelocity() const {
+    return buffer->getVelocity(index);
+}
+
+inline ofVec3f particle_ref::getAcceleration() const {
+    return buffer->getAcceleration(index);
+}
+
+inline float particle_ref::getMass() const {
+    return buffer->getMass(index);
+}
+
+inline void particle_ref::applyForce(ofVec3f force) {
+    buffer->applyForce(index, force);
+}
+
+} // ofxBenG
+
+#endif /* particle_buffer_h */
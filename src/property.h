@@ -1,7 +1,19 @@
 #ifndef property_h
 #define property_h
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "ofxXmlSettings.h"
+#include "value_cell.h"
 
 namespace ofxBenG {
 
@@ -9,18 +21,406 @@ namespace ofxBenG {
 #define CAST_PROPERTY(x) (dynamic_cast<ofxBenG::property_base*>(&x))
 #define CAST_PROPERTY_REFERENCE(x) (dynamic_cast<ofxBenG::property_base*>(x))
 
+class property_base;
+
+/*
+ * Prints "Setting <name> to <value>" lines on its own thread, so the thread that cleans
+ * properties only copies the name and the raw value into a preallocated ring; formatting
+ * happens here. If printing falls QUEUE_LIMIT lines behind, further lines are dropped and
+ * the count is printed with the next line that fits.
+ */
+class log_writer {
+public:
+    static log_writer& getInstance() {
+        static log_writer instance;
+        return instance;
+    }
+    
+    ~log_writer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isRunning = false;
+        }
+        lineReady.notify_one();
+        if (printer.joinable())
+            printer.join();
+    }
+    
+    /* Queues value unformatted when it is small and trivially copyable, and as text otherwise. */
+    template <typename T>
+    void write(const std::string& name, const T& value) {
+        write(name, value, std::integral_constant<bool, std::is_trivially_copyable<T>::value && sizeof(T) <= VALUE_SIZE>());
+    }
+    
+    void write(const std::string& name, const std::string& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        line* queued = reserve(name);
+        if (queued == nullptr)
+            return;
+        queued->text.assign(value);
+        queued->format = nullptr;
+        publish();
+    }
+    
+private:
+    static std::size_t const QUEUE_LIMIT = 1024;
+    static std::size_t const VALUE_SIZE = 32;
+    
+    struct line {
+        std::string name;
+        /* Formats value; null when the line carries text instead. */
+        void (*format)(std::ostream& out, const void* value) = nullptr;
+        typename std::aligned_storage<VALUE_SIZE>::type value;
+        std::string text;
+    };
+    
+    log_writer() : lines(QUEUE_LIMIT) {}
+    
+    template <typename T>
+    static void formatValue(std::ostream& out, const void* value) {
+        out << *static_cast<const T*>(value);
+    }
+    
+    template <typename T>
+    void write(const std::string& name, const T& value, std::true_type) {
+        std::lock_guard<std::mutex> lock(mutex);
+        line* queued = reserve(name);
+        if (queued == nullptr)
+            return;
+        std::memcpy(&queued->value, &value, sizeof(T));
+        queued->format = &formatValue<T>;
+        publish();
+    }
+    
+    template <typename T>
+    void write(const std::string& name, const T& value, std::false_type) {
+        std::ostringstream text;
+        text << value;
+        write(name, text.str());
+    }
+    
+    /* Claims the next free line under the lock, or counts a drop and returns null. */
+    line* reserve(const std::string& name) {
+        if (!printer.joinable())
+            printer = std::thread(&log_writer::printLoop, this);
+        if (count == QUEUE_LIMIT) {
+            droppedCount++;
+            return nullptr;
+        }
+        line& queued = lines[(first + count) % QUEUE_LIMIT];
+        queued.name.assign(name);
+        return &queued;
+    }
+    
+    void publish() {
+        count++;
+        lineReady.notify_one();
+    }
+    
+    /*
+     * Prints until asked to stop, then prints whatever is still queued. Each line is copied
+     * out before unlocking; the ring's and printing's strings keep their capacity, so steady
+     * logging doesn't allocate.
+     */
+    void printLoop() {
+        std::ostringstream out;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            lineReady.wait(lock, [this]() { return !isRunning || count > 0; });
+            if (count == 0)
+                return;
+            line& queued = lines[first];
+            printing.name.assign(queued.name);
+            printing.format = queued.format;
+            if (queued.format != nullptr)
+                std::memcpy(&printing.value, &queued.value, VALUE_SIZE);
+            else
+                printing.text.assign(queued.text);
+            first = (first + 1) % QUEUE_LIMIT;
+            count--;
+            std::size_t const dropped = droppedCount;
+            droppedCount = 0;
+            lock.unlock();
+            out.str(std::string());
+            if (dropped > 0)
+                out << "(" << dropped << " property changes not logged)\n";
+            out << "Setting " << printing.name << " to ";
+            if (printing.format != nullptr)
+                printing.format(out, &printing.value);
+            else
+                out << printing.text;
+            std::cout << out.str() << std::endl;
+            lock.lock();
+        }
+    }
+    
+    std::mutex mutex;
+    std::condition_variable lineReady;
+    std::vector<line> lines;
+    std::size_t first = 0;
+    std::size_t count = 0;
+    std::size_t droppedCount = 0;
+    bool isRunning = true;
+    /* The line being printed; only printLoop() touches it. */
+    line printing;
+    std::thread printer;
+};
+
+/*
+ * Lock-free stack of properties that have been set since they were last cleaned. Any thread
+ * may push; the thread that cleans takes the whole list at once. That thread may also hold
+ * properties over to its next pass on a separate deferred list.
+ */
+class dirty_list {
+public:
+    void push(property_base* property);
+    
+    /* Detaches every queued property, oldest first. */
+    property_base* takeAll();
+    
+    /* Holds a dequeued property for the next takeDeferred(); cleaning thread only. */
+    void defer(property_base* property);
+    
+    /* Detaches every deferred property, oldest first; cleaning thread only. */
+    property_base* takeDeferred();
+    
+    /* Unlinks property from both lists, for a property destroyed on the cleaning thread. */
+    void remove(property_base* property);
+    
+private:
+    std::atomic<property_base*> head = {nullptr};
+    property_base* deferredHead = nullptr;
+};
+
 class property_base {
 public:
     property_base() {}
     
+    /*
+     * Leaves the dirty list, so a property destroyed while queued, like a mirror created this
+     * frame, is never cleaned. Also leaves the dependency graph: upstreams drop the
+     * subscriptions that fed this property and downstreams forget it, whichever side goes
+     * first.
+     */
+    virtual ~property_base() {
+        if (dirtyList != nullptr)
+            dirtyList->remove(this);
+        for (auto upstream : upstreams) {
+            upstream->removeSubscribers(this);
+            erase(upstream->downstreams, this);
+        }
+        for (auto downstream : downstreams) {
+            erase(downstream->upstreams, this);
+        }
+    }
+    
     virtual void clean() = 0;
     virtual void save(ofxXmlSettings& settings) {};
     virtual void load(ofxXmlSettings& settings) {};
     virtual void setScale(float scale) {};
-    virtual float getScale() {};
-    virtual std::string getName() {}
+    virtual float getScale() {
+        return 0;
+    }
+    
+    /* Drops the subscriptions added on behalf of owner. */
+    virtual void removeSubscribers(const property_base* owner) {}
+    
+    virtual std::string getName() {
+        return std::string();
+    }
+    
+    /* True for properties with a name and scale that snapshots and presets can address. */
+    virtual bool isSnapshottable() {
+        return false;
+    }
+    
+    /* True for properties that change on their own and so must be cleaned every frame. */
+    virtual bool isContinuous() {
+        return false;
+    }
+    
+    /*
+     * Queue this property on list whenever it is set, and once now in case a set is already
+     * pending; nullptr to stop queueing. Downstreams that were following the old list, such as
+     * mirrors that were never added to a bag themselves, move to the new one with it.
+     */
+    void setDirtyList(dirty_list* list) {
+        dirty_list* const previous = dirtyList;
+        dirtyList = list;
+        markDirty();
+        if (previous == list)
+            return;
+        for (auto downstream : downstreams) {
+            if (downstream->dirtyList == previous)
+                downstream->setDirtyList(list);
+        }
+    }
+    
+    dirty_list* getDirtyList() const {
+        return dirtyList;
+    }
+    
+    /*
+     * Records that this property is derived from upstream, so property_bag cleans upstream
+     * first. A property's rank is one more than its highest upstream. A property without a
+     * dirty list of its own follows upstream's. Returns false, and records nothing, if the
+     * edge would close a cycle.
+     */
+    bool dependOn(property_base* upstream) {
+        if (upstream == this || upstream->dependsOn(this))
+            return false;
+        upstreams.push_back(upstream);
+        upstream->downstreams.push_back(this);
+        raiseRank(upstream->rank + 1);
+        if (dirtyList == nullptr)
+            setDirtyList(upstream->dirtyList);
+        return true;
+    }
+    
+    bool dependsOn(property_base* other) const {
+        for (auto upstream : upstreams) {
+            if (upstream == other || upstream->dependsOn(other))
+                return true;
+        }
+        return false;
+    }
+    
+    int getRank() const {
+        return rank;
+    }
+    
+    /* Dequeued properties hand on their successor and become queueable again before they are cleaned. */
+    property_base* takeNextDirty() {
+        property_base* next = nextDirty;
+        nextDirty = nullptr;
+        isQueued.store(false, std::memory_order_release);
+        return next;
+    }
+    
+    property_base* takeNextDeferred() {
+        property_base* next = nextDeferred;
+        nextDeferred = nullptr;
+        isDeferred = false;
+        return next;
+    }
+    
+    typedef std::function<void(const std::string& name, const std::string& value)> log_sink;
+    
+    /*
+     * Receives every new value, formatted, as clean() applies it, on the thread that cleans;
+     * pass an empty function to silence logging. Until this is called, clean() hands raw
+     * values to log_writer, which formats and prints them on its own thread.
+     */
+    static void setLogSink(const log_sink& sink) {
+        getLogSink() = sink;
+        isLoggingToWriter() = false;
+    }
+    
+protected:
+    static log_sink& getLogSink() {
+        static log_sink sink;
+        return sink;
+    }
+    
+    static bool& isLoggingToWriter() {
+        static bool isDefault = true;
+        return isDefault;
+    }
+    
+    void markDirty() {
+        if (dirtyList != nullptr && !isQueued.exchange(true, std::memory_order_acq_rel)) {
+            dirtyList->push(this);
+        }
+    }
+    
+private:
+    friend class dirty_list;
+    
+    static void erase(std::vector<property_base*>& properties, property_base* property) {
+        properties.erase(std::remove(properties.begin(), properties.end(), property), properties.end());
+    }
+    
+    void raiseRank(int newRank) {
+        if (newRank <= rank)
+            return;
+        rank = newRank;
+        for (auto downstream : downstreams) {
+            downstream->raiseRank(rank + 1);
+        }
+    }
+    
+    std::vector<property_base*> upstreams;
+    std::vector<property_base*> downstreams;
+    int rank = 0;
+    dirty_list* dirtyList = nullptr;
+    property_base* nextDirty = nullptr;
+    property_base* nextDeferred = nullptr;
+    std::atomic<bool> isQueued = {false};
+    bool isDeferred = false;
 };
 
+inline void dirty_list::push(property_base* property) {
+    property->nextDirty = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(property->nextDirty, property, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+inline property_base* dirty_list::takeAll() {
+    property_base* newest = head.exchange(nullptr, std::memory_order_acquire);
+    property_base* oldest = nullptr;
+    while (newest != nullptr) {
+        property_base* next = newest->nextDirty;
+        newest->nextDirty = oldest;
+        oldest = newest;
+        newest = next;
+    }
+    return oldest;
+}
+
+inline void dirty_list::defer(property_base* property) {
+    if (property->isDeferred)
+        return;
+    property->isDeferred = true;
+    property->nextDeferred = deferredHead;
+    deferredHead = property;
+}
+
+inline property_base* dirty_list::takeDeferred() {
+    property_base* newest = deferredHead;
+    property_base* oldest = nullptr;
+    deferredHead = nullptr;
+    while (newest != nullptr) {
+        property_base* next = newest->nextDeferred;
+        newest->nextDeferred = oldest;
+        oldest = newest;
+        newest = next;
+    }
+    return oldest;
+}
+
+/* Writers may be pushing at the same time, so the queued list is taken whole and everything else pushed back, oldest first. */
+inline void dirty_list::remove(property_base* property) {
+    if (property->isDeferred) {
+        property_base** link = &deferredHead;
+        while (*link != property) {
+            link = &(*link)->nextDeferred;
+        }
+        *link = property->takeNextDeferred();
+    }
+    if (property->isQueued.load(std::memory_order_acquire)) {
+        property_base* queued = takeAll();
+        while (queued != nullptr) {
+            property_base* next = queued->nextDirty;
+            if (queued == property) {
+                property->takeNextDirty();
+            } else {
+                push(queued);
+            }
+            queued = next;
+        }
+    }
+}
+
 template <typename T>
 class property : public property_base {
 public:
@@ -28,23 +428,30 @@ public:
     
     property(const std::string& name, property<T>& other) : name(name) {
         cachedValue = other.get();
-        dirtyValue = cachedValue;
+        pending.seed(cachedValue);
         min = other.getMin();
         max = other.getMax();
-        other.addSubscriber([&]() { set(map(other)); });
+        scale = other.getScale();
+        dependOn(&other);
+        other.addSubscriber([&]() { set(map(other)); }, this);
     }
     
     property(const std::string& name, const T& defaultValue, const T& min, const T& max)
         : name(name),
           cachedValue(defaultValue),
           min(min),
-          max(max) {}
+          max(max),
+          scale(unlerp(defaultValue, min, max)) {
+        pending.seed(cachedValue);
+    }
     
     property(const property<T>& other) {
         name = other.name;
         cachedValue = other.cachedValue;
         min = other.min;
         max = other.max;
+        scale = other.scale;
+        pending.seed(cachedValue);
     }
     
     property<T>& operator=(const property<T>& other) {
@@ -52,6 +459,8 @@ public:
         cachedValue = other.cachedValue;
         min = other.min;
         max = other.max;
+        scale = other.scale;
+        pending.seed(cachedValue);
         return *this;
     }
     
@@ -61,6 +470,10 @@ public:
         return name;
     }
     
+    virtual bool isSnapshottable() {
+        return true;
+    }
+    
     T map(property<T>& other) {
         return map(other.get(), other.getMin(), other.getMax());
     }
@@ -78,7 +491,7 @@ public:
     }
     
     ofVec3f map(int i, float value, float min, float max) {
-        auto v = dirtyValue;
+        auto v = pending.getLatest();
         v[i] = ofMap(value, min, max, getMin()[i], getMax()[i], true);
         return v;
     }
@@ -95,6 +508,20 @@ public:
         return t * max;
     }
     
+    /* The scale lerp() maps to v, so a property's scale matches its value before setScale() is first called. */
+    static float unlerp(float v, float min, float max) {
+        return max == min ? 0 : (v - min) / (max - min);
+    }
+    
+    static float unlerp(int v, int min, int max) {
+        return unlerp((float) v, (float) min, (float) max);
+    }
+    
+    static float unlerp(ofVec3f v, ofVec3f min, ofVec3f max) {
+        float const length = max.length();
+        return length == 0 ? 0 : v.length() / length;
+    }
+    
     int mapTo(int min, int max) {
         return (int)ofMap(get(), getMin(), getMax(), min, max, true);
     }
@@ -132,14 +559,27 @@ public:
         max = value;
     }
     
-    void addSubscriber(const subscription_t& s) {
-        subscribers.push_back(s);
+    /* owner, if given, is the property the subscription feeds; its destructor removes the subscription. */
+    void addSubscriber(const subscription_t& s, const property_base* owner = nullptr) {
+        subscribers.push_back(subscription{s, owner});
+    }
+    
+    virtual void removeSubscribers(const property_base* owner) {
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), [owner](const subscription& s) {
+            return s.owner == owner;
+        }), subscribers.end());
     }
     
     virtual void clean() {
-        if (dirty) {
-            cachedValue = dirtyValue;
-            dirty = false;
+        if (pending.consume(cachedValue)) {
+            log_sink& sink = getLogSink();
+            if (isLoggingToWriter()) {
+                log_writer::getInstance().write(name, cachedValue);
+            } else if (sink) {
+                std::ostringstream value;
+                value << cachedValue;
+                sink(getName(), value.str());
+            }
             notifySubscribers();
         }
     }
@@ -160,16 +600,15 @@ public:
     
     void notifySubscribers() {
         for (auto& subscriber : subscribers) {
-            subscriber();
+            subscriber.notify();
         }
     }
     
+    /* Safe to call from controller threads; the value is published without blocking the reader and picked up by the next clean(). */
     virtual void set(const T& v) {
-        std::lock_guard<std::mutex> guard(mutex);
         if (between(v, min, max)) {
-            std::cout << "Setting " << getName() << " to " << v << std::endl;
-            dirtyValue = v;
-            dirty = true;
+            pending.publish(v);
+            markDirty();
         }
     }
     
@@ -204,37 +643,53 @@ public:
 
     T operator=(const T& v) {
         set(v);
-        return dirtyValue;
+        return pending.getLatest();
     }
     
     T operator+=(const T& v) {
-        set(dirtyValue + v);
-        return dirtyValue;
+        return modify([&](const T& current) { return current + v; });
     }
     
     T operator-=(const T& v) {
-        set(dirtyValue - v);
-        return dirtyValue;
+        return modify([&](const T& current) { return current - v; });
     }
     
     T operator++(int) {
-        set(dirtyValue + 1);
-        return dirtyValue;
+        return modify([](const T& current) { return current + 1; });
     }
     
     T operator--(int) {
-        set(dirtyValue - 1);
-        return dirtyValue;
+        return modify([](const T& current) { return current - 1; });
     }
 private:
+    struct subscription {
+        subscription_t notify;
+        const property_base* owner;
+    };
+    
+    /* Applies f to the latest value set from any thread, atomically with respect to other writers. */
+    template <typename F>
+    T modify(F f) {
+        T result;
+        bool const changed = pending.update([&](T& latest) {
+            T const next = f(latest);
+            bool const isInRange = between(next, min, max);
+            if (isInRange)
+                latest = next;
+            result = latest;
+            return isInRange;
+        });
+        if (changed)
+            markDirty();
+        return result;
+    }
+    
     T min;
     T max;
-    T dirtyValue;
     T cachedValue;
-    bool dirty = false;
-    float scale;
-    std::vector<subscription_t> subscribers;
-    std::mutex mutex;
+    value_cell<T> pending;
+    float scale = 0;
+    std::vector<subscription> subscribers;
     std::string const tag = "property";
     std::string name;
 };
@@ -244,6 +699,10 @@ class jitter : public property_base {
 public:
     jitter(property<T>& target) : target(target) {}
     
+    virtual bool isContinuous() {
+        return true;
+    }
+    
     virtual void clean() {
         target.clean();
         float oldScale = target.getScale();
@@ -2,14 +2,43 @@
 #define propertybag_h
 
 #include "property.h"
+#include "property_snapshot.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace ofxBenG {
 
 class property_bag {
 public:
+    /* Finishes any snapshot saves still queued. */
+    ~property_bag() {
+        {
+            std::lock_guard<std::mutex> lock(saveMutex);
+            isSaving = false;
+        }
+        saveReady.notify_one();
+        if (saver.joinable()) {
+            saver.join();
+        }
+    }
+    
     void add(property_base* property) {
         properties.push_back(property);
+        if (property->isSnapshottable()) {
+            propertiesByName[property_snapshot::hashName(property->getName())].push_back(property);
+        }
+        property->setDirtyList(&dirty);
+        if (property->isContinuous()) {
+            continuous.push_back(property);
+        }
     }
     
     void loadFromXml() {
@@ -33,11 +62,79 @@ public:
         }
         settings.save(file);
     }
+    
+    std::shared_ptr<property_snapshot> capture() {
+        std::shared_ptr<property_snapshot> snapshot(new property_snapshot());
+        for (auto property : properties) {
+            if (property->isSnapshottable()) {
+                snapshot->add(property->getName(), property->getScale());
+            }
+        }
+        snapshot->sortByHash();
+        return snapshot;
+    }
+    
+    /*
+     * Captures the current scales now and queues them for a background thread, which writes
+     * saves in the order they were asked for. Never waits for a save in progress.
+     */
+    void saveSnapshot(const std::string& file) {
+        std::shared_ptr<property_snapshot> snapshot = capture();
+        {
+            std::lock_guard<std::mutex> lock(saveMutex);
+            if (!saver.joinable()) {
+                saver = std::thread(&property_bag::saveLoop, this);
+            }
+            saves.emplace_back(snapshot, file);
+        }
+        saveReady.notify_one();
+    }
+    
+    /* Loads a preset to keep resident and hand to switchTo(); nullptr if the file can't be read. */
+    static std::shared_ptr<const property_snapshot> loadSnapshot(const std::string& file) {
+        std::shared_ptr<property_snapshot> snapshot(new property_snapshot());
+        if (!snapshot->load(file))
+            return nullptr;
+        return snapshot;
+    }
+    
+    /* Applies preset at the start of the next update(), all in that one frame. Callable from any thread. */
+    void switchTo(std::shared_ptr<const property_snapshot> preset) {
+        std::atomic_store(&pendingPreset, preset);
+    }
 
+    /*
+     * Cleans only the properties set since the last update, plus the continuous ones, in rank
+     * order: every upstream is cleaned before anything derived from it. Cleaning a property
+     * queues its mirrors, and they are picked up at their own rank in the same update. A
+     * property fed by several changed upstreams is therefore cleaned once, after all of them.
+     * Anything set again after its rank has been passed, by a subscriber writing upstream or
+     * by an undeclared cycle, waits for the next update, so each update cleans a property at
+     * most once and always finishes.
+     */
     void update() {
-        for (auto property : properties) {
+        std::shared_ptr<const property_snapshot> preset = std::atomic_exchange(&pendingPreset, std::shared_ptr<const property_snapshot>());
+        if (preset) {
+            apply(*preset);
+        }
+        for (auto property : continuous) {
             property->clean();
         }
+        property_base* property = dirty.takeDeferred();
+        while (property != nullptr) {
+            property_base* next = property->takeNextDeferred();
+            schedule(property, property->getRank());
+            property = next;
+        }
+        collectDirty(0);
+        for (std::size_t rank = 0; rank < ranks.size(); rank++) {
+            std::vector<property_base*>& bucket = ranks[rank];
+            for (std::size_t i = 0; i < bucket.size(); i++) {
+                bucket[i]->clean();
+            }
+            bucket.clear();
+            collectDirty(rank + 1);
+        }
     }
 
     template<typename Functor>
@@ -45,7 +142,65 @@ public:
         std::for_each(properties.begin(), properties.end(), f);
     }
 private:
+    /* Saves until the bag is destroyed, then saves whatever is still queued. */
+    void saveLoop() {
+        std::unique_lock<std::mutex> lock(saveMutex);
+        while (true) {
+            saveReady.wait(lock, [this]() { return !isSaving || !saves.empty(); });
+            if (saves.empty())
+                return;
+            std::pair<std::shared_ptr<property_snapshot>, std::string> const save = std::move(saves.front());
+            saves.pop_front();
+            lock.unlock();
+            save.first->save(save.second);
+            lock.lock();
+        }
+    }
+    
+    void apply(const property_snapshot& preset) {
+        for (const property_snapshot::entry& e : preset.getEntries()) {
+            auto match = propertiesByName.find(e.nameHash);
+            if (match != propertiesByName.end()) {
+                for (auto property : match->second) {
+                    property->setScale(e.scale);
+                }
+            }
+        }
+    }
+    
+    /* Buckets queued properties by rank; anything queued below minimumRank has been passed this update and is deferred to the next. */
+    void collectDirty(std::size_t minimumRank) {
+        property_base* property = dirty.takeAll();
+        while (property != nullptr) {
+            property_base* next = property->takeNextDirty();
+            std::size_t const rank = property->getRank();
+            if (rank < minimumRank) {
+                dirty.defer(property);
+            } else {
+                schedule(property, rank);
+            }
+            property = next;
+        }
+    }
+    
+    void schedule(property_base* property, std::size_t rank) {
+        if (rank >= ranks.size()) {
+            ranks.resize(rank + 1);
+        }
+        ranks[rank].push_back(property);
+    }
+    
     std::vector<property_base*> properties;
+    std::vector<property_base*> continuous;
+    dirty_list dirty;
+    std::vector<std::vector<property_base*>> ranks;
+    std::unordered_map<uint64_t, std::vector<property_base*>> propertiesByName;
+    std::shared_ptr<const property_snapshot> pendingPreset;
+    std::mutex saveMutex;
+    std::condition_variable saveReady;
+    std::deque<std::pair<std::shared_ptr<property_snapshot>, std::string>> saves;
+    bool isSaving = true;
+    std::thread saver;
     ofxXmlSettings settings;
 };
     
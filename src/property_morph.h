@@ -0,0 +1,107 @@
+#ifndef property_morph_h
+#define property_morph_h
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "property_bag.h"
+#include "property_snapshot.h"
+
+namespace ofxBenG {
+
+/*
+ * Moves every property of a bag through a sequence of preset snapshots, spending a fixed
+ * number of beats on each leg. Scales are kept as one contiguous array per preset, so a frame
+ * is a single interpolation pass, and only properties whose scale moved are set; those then
+ * reach their mirrors through the bag's dirty list on the next update().
+ */
+class property_morph {
+public:
+    property_morph(property_bag& bag) : bag(bag) {}
+
+    /* Presets missing a property hold that property at the scale it had when start() was called. */
+    void start(const std::vector<std::shared_ptr<const property_snapshot>>& presets, float startBeat, float beatsPerLeg) {
+        targets.clear();
+        bag.apply([this](property_base* property) {
+            if (property->isSnapshottable()) {
+                targets.push_back(property);
+            }
+        });
+
+        std::size_t const count = targets.size();
+        std::vector<uint64_t> hashes(count);
+        std::vector<float> current(count);
+        for (std::size_t i = 0; i < count; i++) {
+            hashes[i] = property_snapshot::hashName(targets[i]->getName());
+            current[i] = targets[i]->getScale();
+        }
+
+        scales.assign(presets.size(), std::vector<float>());
+        for (std::size_t p = 0; p < presets.size(); p++) {
+            property_snapshot::entries_view const entries = presets[p]->getEntries();
+            std::vector<float>& preset = scales[p];
+            preset.resize(count);
+            for (std::size_t i = 0; i < count; i++) {
+                auto match = std::lower_bound(entries.begin(), entries.end(), hashes[i], [](const property_snapshot::entry& e, uint64_t hash) {
+                    return e.nameHash < hash;
+                });
+                preset[i] = (match != entries.end() && match->nameHash == hashes[i]) ? match->scale : current[i];
+            }
+        }
+
+        this->startBeat = startBeat;
+        this->beatsPerLeg = std::max(beatsPerLeg, 0.0f);
+        output.assign(count, 0.0f);
+        applied = current;
+    }
+
+    void update(float beat) {
+        if (scales.empty())
+            return;
+
+        std::size_t const legs = scales.size() - 1;
+        float position = (beatsPerLeg > 0) ? (beat - startBeat) / beatsPerLeg : (float) legs;
+        position = std::min(std::max(position, 0.0f), (float) legs);
+        std::size_t const leg = std::min((std::size_t) position, (legs > 0) ? legs - 1 : 0);
+        float const t = (legs > 0) ? position - leg : 0.0f;
+
+        interpolate(scales[leg].data(), scales[std::min(leg + 1, legs)].data(), t, output.data(), output.size());
+
+        for (std::size_t i = 0; i < output.size(); i++) {
+            if (output[i] != applied[i]) {
+                applied[i] = output[i];
+                targets[i]->setScale(output[i]);
+            }
+        }
+    }
+
+    bool isDone(float beat) const {
+        return scales.empty() || beat >= getEndBeat();
+    }
+
+    float getEndBeat() const {
+        return startBeat + beatsPerLeg * (scales.empty() ? 0 : scales.size() - 1);
+    }
+
+private:
+    /* Weighted on both ends, so a leg starts and ends exactly on its presets' scales. */
+    static void interpolate(const float* __restrict from, const float* __restrict to, float t, float* __restrict out, std::size_t count) {
+        float const u = 1.0f - t;
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = from[i] * u + to[i] * t;
+        }
+    }
+
+    property_bag& bag;
+    std::vector<property_base*> targets;
+    std::vector<std::vector<float>> scales;
+    std::vector<float> output;
+    std::vector<float> applied;
+    float startBeat = 0;
+    float beatsPerLeg = 0;
+};
+
+} // ofxBenG
+
+#endif /* property_morph_h */
@@ -0,0 +1,230 @@
+#ifndef property_snapshot_h
+#define property_snapshot_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ofxBenG {
+
+/*
+ * The scales of a set of properties, keyed by a 64-bit FNV-1a hash of each name and sorted by
+ * hash. On disk it is a 16-byte header (magic, version, entry count, reserved) followed by
+ * 16-byte entries laid out like entry in native byte order: hash, scale, 4 zero bytes. A
+ * loaded snapshot reads its entries straight from the mapped file. Version 1 files, with
+ * packed 12-byte entries, still load by copying.
+ */
+class property_snapshot {
+public:
+    struct entry {
+        uint64_t nameHash;
+        float scale;
+    };
+
+    /* The entries of a snapshot, wherever they live. */
+    class entries_view {
+    public:
+        entries_view(const entry* first, std::size_t count) : first(first), count(count) {}
+
+        const entry* begin() const {
+            return first;
+        }
+
+        const entry* end() const {
+            return first + count;
+        }
+
+        std::size_t size() const {
+            return count;
+        }
+
+    private:
+        const entry* first;
+        std::size_t count;
+    };
+
+    static uint32_t const MAGIC = 0x47424f50; /* "POBG" */
+    static uint32_t const VERSION = 2;
+
+    property_snapshot() {}
+
+    property_snapshot(const property_snapshot&) = delete;
+    property_snapshot& operator=(const property_snapshot&) = delete;
+
+    ~property_snapshot() {
+        unmap();
+    }
+
+    static uint64_t hashName(const std::string& name) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : name) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /* Appends an entry; call sortByHash() once all are added and before sharing the snapshot. */
+    void add(const std::string& name, float scale) {
+        copyMapped();
+        entries.push_back({hashName(name), scale});
+        isSorted = false;
+    }
+
+    void sortByHash() {
+        if (isSorted)
+            return;
+        std::stable_sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+            return a.nameHash < b.nameHash;
+        });
+        isSorted = true;
+    }
+
+    entries_view getEntries() const {
+        return mapped != nullptr ? entries_view(mappedEntries, mappedCount) : entries_view(entries.data(), entries.size());
+    }
+
+    std::size_t size() const {
+        return getEntries().size();
+    }
+
+    bool save(const std::string& file) {
+        sortByHash();
+        entries_view const view = getEntries();
+        std::vector<char> bytes(HEADER_SIZE + view.size() * ENTRY_SIZE);
+        uint32_t const header[4] = {MAGIC, VERSION, (uint32_t) view.size(), 0};
+        std::memcpy(bytes.data(), header, HEADER_SIZE);
+        char* out = bytes.data() + HEADER_SIZE;
+        for (const entry& e : view) {
+            std::memcpy(out, &e.nameHash, sizeof(e.nameHash));
+            std::memcpy(out + sizeof(e.nameHash), &e.scale, sizeof(e.scale));
+            out += ENTRY_SIZE;
+        }
+
+        std::string const temporary = file + ".tmp";
+        {
+            std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+            if (!stream.write(bytes.data(), bytes.size()))
+                return false;
+        }
+        return std::rename(temporary.c_str(), file.c_str()) == 0;
+    }
+
+    /* Maps the file read-only and keeps it mapped for the entries; false if it is missing, truncated or of another version. */
+    bool load(const std::string& file) {
+        unmap();
+        entries.clear();
+#ifndef _WIN32
+        int fd = ::open(file.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < (off_t) HEADER_SIZE) {
+            ::close(fd);
+            return false;
+        }
+        std::size_t const length = info.st_size;
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED)
+            return false;
+        const char* const bytes = static_cast<const char*>(address);
+        uint32_t count;
+        if (parseHeader(bytes, length, VERSION, ENTRY_SIZE, count)) {
+            mapped = address;
+            mappedLength = length;
+            mappedEntries = reinterpret_cast<const entry*>(bytes + HEADER_SIZE);
+            mappedCount = count;
+            isSorted = true;
+            return true;
+        }
+        bool const isLoaded = parseVersion1(bytes, length);
+        ::munmap(address, length);
+        return isLoaded;
+#else
+        std::ifstream stream(file, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        uint32_t count;
+        if (parseHeader(bytes.data(), bytes.size(), VERSION, ENTRY_SIZE, count)) {
+            entries.resize(count);
+            std::memcpy(entries.data(), bytes.data() + HEADER_SIZE, count * ENTRY_SIZE);
+            isSorted = true;
+            return true;
+        }
+        return parseVersion1(bytes.data(), bytes.size());
+#endif
+    }
+
+private:
+    static std::size_t const HEADER_SIZE = 16;
+    static std::size_t const ENTRY_SIZE = 16;
+    static std::size_t const VERSION_1_ENTRY_SIZE = 12;
+
+    static_assert(sizeof(entry) == ENTRY_SIZE, "entries are used in place from the mapped file");
+
+    static bool parseHeader(const char* bytes, std::size_t length, uint32_t version, std::size_t entrySize, uint32_t& count) {
+        if (length < HEADER_SIZE)
+            return false;
+        uint32_t header[4];
+        std::memcpy(header, bytes, HEADER_SIZE);
+        if (header[0] != MAGIC || header[1] != version || length < HEADER_SIZE + header[2] * entrySize)
+            return false;
+        count = header[2];
+        return true;
+    }
+
+    bool parseVersion1(const char* bytes, std::size_t length) {
+        uint32_t count;
+        if (!parseHeader(bytes, length, 1, VERSION_1_ENTRY_SIZE, count))
+            return false;
+        entries.resize(count);
+        const char* in = bytes + HEADER_SIZE;
+        for (entry& e : entries) {
+            std::memcpy(&e.nameHash, in, sizeof(e.nameHash));
+            std::memcpy(&e.scale, in + sizeof(e.nameHash), sizeof(e.scale));
+            in += VERSION_1_ENTRY_SIZE;
+        }
+        isSorted = true;
+        return true;
+    }
+
+    /* Before a loaded snapshot is changed, its entries move out of the read-only mapping. */
+    void copyMapped() {
+        if (mapped == nullptr)
+            return;
+        entries.assign(mappedEntries, mappedEntries + mappedCount);
+        unmap();
+    }
+
+    void unmap() {
+#ifndef _WIN32
+        if (mapped != nullptr)
+            ::munmap(mapped, mappedLength);
+#endif
+        mapped = nullptr;
+        mappedLength = 0;
+        mappedEntries = nullptr;
+        mappedCount = 0;
+    }
+
+    std::vector<entry> entries;
+    void* mapped = nullptr;
+    std::size_t mappedLength = 0;
+    const entry* mappedEntries = nullptr;
+    std::size_t mappedCount = 0;
+    bool isSorted = true;
+};
+
+} // ofxBenG
+
+#endif /* property_snapshot_h */
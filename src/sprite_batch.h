@@ -0,0 +1,89 @@
+#ifndef sprite_batch_h
+#define sprite_batch_h
+
+#include <vector>
+#include "ofMain.h"
+
+namespace ofxBenG {
+
+/*
+ * Collects textured quads and draws them with one texture bind and one draw call per
+ * texture when flushed. Callers add sprites for as many tracers as they like during a
+ * frame and flush() once at the end.
+ */
+class sprite_batch {
+public:
+    /* Queues texture drawn with its top-left corner at (x, y), the way ofImage::draw(x, y) places it. */
+    void add(ofTexture& texture, float x, float y) {
+        add(texture, x, y, texture.getWidth(), texture.getHeight());
+    }
+
+    void add(ofTexture& texture, float x, float y, float w, float h) {
+        batch& b = getBatch(texture);
+        ofIndexType const base = b.mesh.getNumVertices();
+        b.mesh.addVertex(ofVec3f(x, y, 0));
+        b.mesh.addVertex(ofVec3f(x + w, y, 0));
+        b.mesh.addVertex(ofVec3f(x + w, y + h, 0));
+        b.mesh.addVertex(ofVec3f(x, y + h, 0));
+        b.mesh.addTexCoord(b.topLeft);
+        b.mesh.addTexCoord(ofVec2f(b.bottomRight.x, b.topLeft.y));
+        b.mesh.addTexCoord(b.bottomRight);
+        b.mesh.addTexCoord(ofVec2f(b.topLeft.x, b.bottomRight.y));
+        b.mesh.addIndex(base);
+        b.mesh.addIndex(base + 1);
+        b.mesh.addIndex(base + 2);
+        b.mesh.addIndex(base);
+        b.mesh.addIndex(base + 2);
+        b.mesh.addIndex(base + 3);
+    }
+
+    /* Draws everything queued since the last flush in the current style and transform. */
+    void flush() {
+        for (batch& b : batches) {
+            if (b.mesh.getNumVertices() == 0)
+                continue;
+            b.texture->bind();
+            b.mesh.draw();
+            b.texture->unbind();
+            b.mesh.clear();
+            drawCalls++;
+        }
+    }
+
+    int getDrawCallCount() const {
+        return drawCalls;
+    }
+
+    void resetDrawCallCount() {
+        drawCalls = 0;
+    }
+
+private:
+    struct batch {
+        ofTexture* texture;
+        ofVec2f topLeft;
+        ofVec2f bottomRight;
+        ofMesh mesh;
+    };
+
+    batch& getBatch(ofTexture& texture) {
+        for (batch& b : batches) {
+            if (b.texture == &texture)
+                return b;
+        }
+        batches.push_back(batch());
+        batch& b = batches.back();
+        b.texture = &texture;
+        b.topLeft = texture.getCoordFromPercent(0, 0);
+        b.bottomRight = texture.getCoordFromPercent(1, 1);
+        b.mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+        return b;
+    }
+
+    std::vector<batch> batches;
+    int drawCalls = 0;
+};
+
+} // ofxBenG
+
+#endif /* sprite_batch_h */
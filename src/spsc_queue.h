@@ -0,0 +1,53 @@
+#ifndef spsc_queue_h
+#define spsc_queue_h
+
+#include <atomic>
+#include <cstddef>
+
+namespace ofxBenG {
+
+    /*
+     * Fixed-capacity, wait-free single-producer/single-consumer ring. One thread may push
+     * and one other thread may pop; neither ever blocks or allocates.
+     */
+    template <typename T, std::size_t Capacity>
+    class spsc_queue {
+    public:
+        static_assert((Capacity & (Capacity - 1)) == 0, "spsc_queue capacity must be a power of two");
+
+        bool push(const T &value) {
+            std::size_t const tail = writeIndex.load(std::memory_order_relaxed);
+            if (tail - readIndex.load(std::memory_order_acquire) == Capacity)
+                return false;
+            items[tail & (Capacity - 1)] = value;
+            writeIndex.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(T &value) {
+            std::size_t const head = readIndex.load(std::memory_order_relaxed);
+            if (head == writeIndex.load(std::memory_order_acquire))
+                return false;
+            value = items[head & (Capacity - 1)];
+            readIndex.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /* Exact only when neither side is running concurrently, e.g. the consumer has stopped. */
+        std::size_t size() {
+            return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+        }
+
+        bool isEmpty() {
+            return readIndex.load(std::memory_order_acquire) == writeIndex.load(std::memory_order_acquire);
+        }
+
+    private:
+        T items[Capacity];
+        alignas(64) std::atomic<std::size_t> writeIndex = {0};
+        alignas(64) std::atomic<std::size_t> readIndex = {0};
+    };
+
+} // ofxBenG
+
+#endif /* spsc_queue_h */
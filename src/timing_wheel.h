@@ -0,0 +1,297 @@
+#ifndef timing_wheel_h
+#define timing_wheel_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace ofxBenG {
+
+    /* Where a timing_wheel's slots come from unless it is given a pool: the global heap. */
+    struct heap_slot_pool {
+        static void *allocate(std::size_t size) {
+            return ::operator new(size);
+        }
+
+        static void release(void *p, std::size_t size) {
+            ::operator delete(p);
+        }
+    };
+
+    /*
+     * Hierarchical timing wheel. Keys are quantized into ticks; level 0 holds the next
+     * 64 ticks, each further level covers 64 times the span of the one below, and
+     * anything past the last level waits in an overflow bucket. Insert is O(1) and
+     * advancing is amortized O(1) per expired item.
+     *
+     * Slots are intrusive singly linked lists: Traits::keyOf(node) returns the node's key
+     * and Traits::nextOf(node) returns a reference to the node's link, so scheduling a
+     * node never allocates. Nodes due on the same key come out in the order they were
+     * inserted: inserts append, and cascaded nodes go after any earlier cascaded ones but
+     * ahead of those inserted straight into the lower slot, which were necessarily
+     * inserted later. Higher levels always cascade before lower ones for this to hold.
+     *
+     * Levels 2 and up are cascaded ahead of time, a few nodes per tick, in the last
+     * sub-rotation before the wheel rolls into them, so one advance() never moves a whole
+     * slot of a busy level at once. Each level finishes before the one below starts.
+     *
+     * The slots are one block taken from Pool, which has static allocate(size) and
+     * release(p, size) like action_pool, on the first insert; a wheel that never schedules
+     * anything never takes it.
+     */
+    template <typename Node, typename Key, typename Traits, typename Pool = heap_slot_pool>
+    class timing_wheel {
+    public:
+        timing_wheel(double ticksPerUnit) : ticksPerUnit(ticksPerUnit) {
+        }
+
+        timing_wheel(const timing_wheel &) = delete;
+        timing_wheel &operator=(const timing_wheel &) = delete;
+
+        ~timing_wheel() {
+            if (slots != nullptr)
+                Pool::release(slots, slotsBytes);
+        }
+
+        /* Schedules node at its key. currentKey is the caller's present time; an empty wheel re-anchors to it. */
+        void insert(Node *node, Key currentKey) {
+            if (slots == nullptr) {
+                slots = static_cast<bucket *>(Pool::allocate(slotsBytes));
+                for (int i = 0; i < slotCount; i++)
+                    new (&slots[i]) bucket();
+            }
+            if (count == 0) {
+                now = tickOf(currentKey);
+            }
+            pushBack(slotFor(tickOf(Traits::keyOf(node))), node);
+            count++;
+        }
+
+        /* Appends every node whose key is <= currentKey to expired, in key order. */
+        void advance(Key currentKey, std::vector<Node *> &expired) {
+            if (count == 0) {
+                /* Nothing to walk past, so an idle wheel never has a backlog of ticks to catch up on. */
+                now = tickOf(currentKey);
+                return;
+            }
+
+            std::size_t const firstExpired = expired.size();
+            int64_t const target = tickOf(currentKey);
+            while (now < target) {
+                drain(slots[slotIndex(0, now)], expired);
+                now++;
+                cascade();
+                cascadeAhead();
+            }
+
+            bucket &current = slots[slotIndex(0, now)];
+            Node *node = current.head;
+            current = bucket();
+            while (node != nullptr) {
+                Node *next = Traits::nextOf(node);
+                Traits::nextOf(node) = nullptr;
+                if (Traits::keyOf(node) <= currentKey) {
+                    expired.push_back(node);
+                } else {
+                    pushBack(current, node);
+                }
+                node = next;
+            }
+
+            count -= expired.size() - firstExpired;
+            sortByKey(expired, firstExpired);
+        }
+
+        void clear() {
+            if (slots != nullptr) {
+                for (int i = 0; i < slotCount; i++)
+                    unlinkAll(slots[i]);
+            }
+            unlinkAll(overflow);
+            count = 0;
+        }
+
+        std::size_t size() {
+            return count;
+        }
+
+        static int const slotBits = 6;
+        static int const slotsPerLevel = 1 << slotBits;
+        static int const levelCount = 4;
+
+    private:
+        struct bucket {
+            Node *head = nullptr;
+            Node *tail = nullptr;
+            /* The last node that arrived by cascade; nodes inserted directly all follow it. */
+            Node *cascaded = nullptr;
+            std::size_t size = 0;
+        };
+
+        static int const slotCount = levelCount * slotsPerLevel;
+        static std::size_t const slotsBytes = slotCount * sizeof(bucket);
+
+        int64_t tickOf(Key key) {
+            return (int64_t) std::floor(key * ticksPerUnit);
+        }
+
+        std::size_t slotIndex(int level, int64_t tick) {
+            return level * slotsPerLevel + ((tick >> (level * slotBits)) & (slotsPerLevel - 1));
+        }
+
+        bucket &slotFor(int64_t tick) {
+            if (tick <= now)
+                return slots[slotIndex(0, now)];
+            int64_t const delta = tick - now;
+            for (int level = 0; level < levelCount; level++) {
+                if (delta < (int64_t(1) << ((level + 1) * slotBits)))
+                    return slots[slotIndex(level, tick)];
+            }
+            return overflow;
+        }
+
+        static void pushBack(bucket &b, Node *node) {
+            Traits::nextOf(node) = nullptr;
+            if (b.tail != nullptr) {
+                Traits::nextOf(b.tail) = node;
+            } else {
+                b.head = node;
+            }
+            b.tail = node;
+            b.size++;
+        }
+
+        /* Puts a node brought down from a higher level after the earlier cascaded nodes and before the directly inserted ones. */
+        static void pushCascaded(bucket &b, Node *node) {
+            if (b.cascaded == nullptr) {
+                Traits::nextOf(node) = b.head;
+                b.head = node;
+            } else {
+                Traits::nextOf(node) = Traits::nextOf(b.cascaded);
+                Traits::nextOf(b.cascaded) = node;
+            }
+            if (Traits::nextOf(node) == nullptr)
+                b.tail = node;
+            b.cascaded = node;
+            b.size++;
+        }
+
+        static Node *popFront(bucket &b) {
+            Node *node = b.head;
+            b.head = Traits::nextOf(node);
+            if (b.head == nullptr)
+                b.tail = nullptr;
+            if (b.cascaded == node)
+                b.cascaded = nullptr;
+            Traits::nextOf(node) = nullptr;
+            b.size--;
+            return node;
+        }
+
+        /* Redistributes the slots the wheel has just rolled into, highest level first. */
+        void cascade() {
+            int64_t const wheelSpan = int64_t(1) << (levelCount * slotBits);
+            if ((now & (wheelSpan - 1)) == 0)
+                redistribute(overflow);
+
+            for (int level = levelCount - 1; level >= 1; level--) {
+                int64_t const lowerSpan = int64_t(1) << (level * slotBits);
+                if ((now & (lowerSpan - 1)) == 0)
+                    redistribute(slots[slotIndex(level, now)]);
+            }
+        }
+
+        /* Walks the bucket oldest first, so every slot it feeds keeps insertion order. The overflow can feed itself. */
+        void redistribute(bucket &from) {
+            bucket nodes = from;
+            from = bucket();
+            while (nodes.head != nullptr) {
+                Node *node = popFront(nodes);
+                pushCascaded(slotFor(tickOf(Traits::keyOf(node))), node);
+            }
+        }
+
+        /*
+         * Moves part of the next level slot the wheel will roll into down one level. A level L
+         * slot starting at tick T only holds ticks in [T, T + 64^L), so its nodes can go into
+         * the level L-1 slot of their own tick: each of those either has already rolled this
+         * rotation or rolls exactly at that node's sub-slot. Level L works through its slot
+         * from 64^(L-1) ticks before T until level L-1 starts on the same T, moving an even
+         * share per tick; cascade() picks up anything inserted after that.
+         *
+         * Nothing is moved ahead for a T the overflow cascades at while it holds anything,
+         * since overflow nodes cascading at T could land beside these and are older than them.
+         */
+        void cascadeAhead() {
+            int64_t const wheelSpan = int64_t(1) << (levelCount * slotBits);
+            for (int level = levelCount - 1; level >= 2; level--) {
+                int64_t const span = int64_t(1) << (level * slotBits);
+                int64_t const start = ((now >> (level * slotBits)) + 1) << (level * slotBits);
+                if ((start & (wheelSpan - 1)) == 0 && overflow.head != nullptr)
+                    continue;
+                int64_t const windowStart = start - (span >> slotBits);
+                int64_t const windowEnd = (level > 2) ? start - (span >> (2 * slotBits)) : start;
+                if (now < windowStart || now >= windowEnd)
+                    continue;
+
+                bucket &upcoming = slots[slotIndex(level, start)];
+                int64_t const ticksLeft = windowEnd - now;
+                std::size_t moves = (upcoming.size + ticksLeft - 1) / ticksLeft;
+                while (moves-- > 0 && upcoming.head != nullptr) {
+                    Node *node = popFront(upcoming);
+                    pushCascaded(slots[slotIndex(level - 1, tickOf(Traits::keyOf(node)))], node);
+                }
+            }
+        }
+
+        /*
+         * Stable insertion sort of expired from first on. Ticks already come out in order, so
+         * only nodes sharing a tick are ever out of place, and unlike std::stable_sort this
+         * never allocates.
+         */
+        static void sortByKey(std::vector<Node *> &expired, std::size_t first) {
+            for (std::size_t i = first + 1; i < expired.size(); i++) {
+                Node *node = expired[i];
+                Key const key = Traits::keyOf(node);
+                std::size_t j = i;
+                while (j > first && key < Traits::keyOf(expired[j - 1])) {
+                    expired[j] = expired[j - 1];
+                    j--;
+                }
+                expired[j] = node;
+            }
+        }
+
+        void drain(bucket &slot, std::vector<Node *> &expired) {
+            Node *node = slot.head;
+            slot = bucket();
+            while (node != nullptr) {
+                Node *next = Traits::nextOf(node);
+                Traits::nextOf(node) = nullptr;
+                expired.push_back(node);
+                node = next;
+            }
+        }
+
+        void unlinkAll(bucket &b) {
+            Node *node = b.head;
+            b = bucket();
+            while (node != nullptr) {
+                Node *next = Traits::nextOf(node);
+                Traits::nextOf(node) = nullptr;
+                node = next;
+            }
+        }
+
+        double ticksPerUnit;
+        int64_t now = 0;
+        std::size_t count = 0;
+        bucket *slots = nullptr;
+        bucket overflow;
+    };
+
+} // ofxBenG
+
+#endif /* timing_wheel_h */
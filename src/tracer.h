@@ -1,7 +1,16 @@
 #ifndef tracer_h
 #define tracer_h
 
+#include <atomic>
+#include <mutex>
+#include <random>
 #include "ofxIntersection.h"
+#include "property.h"
+#include "particle_buffer.h"
+#include "trail_mesh.h"
+#include "trail_instancer.h"
+#include "sprite_batch.h"
+#include "noise_batch.h"
 
 namespace ofxBenG {
 
@@ -9,6 +18,10 @@ class Tracer;
 
 class TracerUpdateStrategy {
 public:
+    /* Cleans the strategy's own mirror properties. Runs on the thread that owns them, before any update(). */
+    virtual void clean() {}
+    
+    /* May run on a worker thread, so it only reads the strategy's properties. */
     virtual void update(Tracer* t, float time) = 0;
 };
 
@@ -17,35 +30,6 @@ public:
     virtual void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) = 0;
 };
 
-class Particle {
-public:
-    Particle(ofVec3f location, ofVec3f velocity = ofVec3f::zero(), float mass = 0) {
-        this->location = location;
-        this->velocity = velocity;
-        this->mass = mass;
-    }
-    
-    void applyForce(ofVec3f force) {
-        force /= mass;
-        acceleration += force;
-    }
-    
-    void update() {
-        velocity += acceleration;
-        location += velocity;
-        acceleration *= 0;
-    }
-    
-    void setLocation(ofVec3f location) {
-        this->location = location;
-    }
-    
-    ofVec3f location;
-    ofVec3f velocity;
-    ofVec3f acceleration;
-    float mass;
-};
-
 class Tracer {
 public:
     Tracer(ofVec3f startLocation, ofVec3f stageSize)
@@ -65,17 +49,56 @@ public:
     }
     
     void update(float time) {
+        clean();
+        advance(time);
+    }
+    
+    /* Cleans every update strategy's mirror properties; call on the thread that owns them. */
+    void clean() {
+        for (TracerUpdateStrategy* s : updateStrategies) {
+            s->clean();
+        }
+    }
+    
+    /* update() without the clean(), for worker threads once clean() has run on the owning thread. */
+    void advance(float time) {
+        step(time);
+        particles.integrate();
+    }
+    
+    /* Runs the update strategies without stepping the particles, for callers that integrate a batch of tracers at once. */
+    void step(float time) {
         for (TracerUpdateStrategy* s : updateStrategies) {
             s->update(this, time);
         }
     }
     
+    /* Steps the particles of count tracers, walking each one's SoA arrays in turn. */
+    static void integrate(Tracer* const* tracers, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            tracers[i]->particles.integrate();
+        }
+    }
+    
+    static void integrate(const std::vector<Tracer*>& tracers) {
+        integrate(tracers.data(), tracers.size());
+    }
+    
     void draw(float time, std::shared_ptr<ofBaseRenderer> renderer) {
         for (TracerDrawStrategy* s : drawStrategies) {
             s->draw(this, time, renderer);
         }
     }
     
+    /* Seeds this tracer's own generator so strategies can draw random numbers reproducibly from any thread. */
+    void setSeed(uint32_t seed) {
+        random.seed(seed);
+    }
+    
+    float getRandom(float min, float max) {
+        return std::uniform_real_distribution<float>(min, max)(random);
+    }
+    
     void mapDimension(int dimension, ofVec2f range) {
         head[dimension] = ofMap(head[dimension],
                                 -0.5 * stageSize[dimension],
@@ -84,20 +107,25 @@ public:
                                 range[1]);
     }
     
-    Particle* getHead() {
-        return (particles.size() > 0) ? particles[particles.size()-1] : nullptr;
+    particle_ref getHead() {
+        return particles.back();
     }
     
-    Particle* getTail() {
-        return (particles.size() > 0) ? particles[0] : nullptr;
+    particle_ref getTail() {
+        return particles.front();
     }
     
     ofVec3f head;
     ofVec3f stageSize;
+    /* Stroke and fill style; it only holds the curve itself when filled, see CurvedPath. */
     ofPath path;
-    std::deque<Particle*> particles;
+    trail_mesh trail;
+    particle_buffer particles;
     std::vector<TracerUpdateStrategy*> updateStrategies;
     std::vector<TracerDrawStrategy*> drawStrategies;
+    
+private:
+    std::mt19937 random;
 };
 
 template <class T>
@@ -121,15 +149,42 @@ public:
 class Multiplier : public TracerDrawStrategy {
 public:
     Multiplier(property<int>& multiplierCount, property<float>& maxShift) : multiplierCount("multiplierCount", multiplierCount), maxShift("multiplierMaxShift", maxShift) {
-        this->shifts = getRandomShifts();
+        randomizeShifts();
         this->maxShift.addSubscriber([&]() {
-            this->shifts = getRandomShifts();
+            randomizeShifts();
         });
         this->multiplierCount.addSubscriber([&]() {
-            this->shifts = getRandomShifts();
+            randomizeShifts();
         });
     }
     
+    void setShifts(const std::vector<ofVec3f>& shifts) {
+        this->shifts = shifts;
+        instancer.setOffsets(shifts);
+    }
+    
+    /* Same as setShifts(getRandomShifts()), reusing the existing storage so it can run every frame. */
+    void randomizeShifts() {
+        shifts.resize(std::max(0, (int) multiplierCount));
+        for (auto& shift : shifts) {
+            shift = getRandomShift();
+        }
+        instancer.setOffsets(shifts);
+    }
+    
+    void setMode(trail_instancer::mode m) {
+        instancer.setMode(m);
+    }
+    
+    /* Same as randomizeShifts(), drawing from t's seeded generator so the shifts repeat run to run. */
+    void randomizeShifts(Tracer* t) {
+        shifts.resize(std::max(0, (int) multiplierCount));
+        for (auto& shift : shifts) {
+            shift = getRandomShift(t);
+        }
+        instancer.setOffsets(shifts);
+    }
+    
     ofVec3f getRandomShift() {
         float const maxShift = this->maxShift;
         ofVec3f randomShift;
@@ -139,6 +194,15 @@ public:
         return randomShift;
     }
     
+    ofVec3f getRandomShift(Tracer* t) {
+        float const maxShift = this->maxShift;
+        ofVec3f randomShift;
+        randomShift.x = t->getRandom(-1 * maxShift, maxShift);
+        randomShift.y = t->getRandom(-1 * maxShift, maxShift);
+        randomShift.z = t->getRandom(-1 * maxShift, maxShift);
+        return randomShift;
+    }
+    
     std::vector<ofVec3f> getRandomShifts() {
         std::vector<ofVec3f> shifts;
         for (int i = 0; i < multiplierCount; i++) {
@@ -151,15 +215,21 @@ public:
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
         multiplierCount.clean();
         maxShift.clean();
-        if (t->particles.size() >= 2) {
-            for (int i = 0; i < multiplierCount; i++) {
-                if (i < shifts.size()) {
-                    ofPushMatrix();
-                    ofVec3f shift = shifts[i];
-                    ofTranslate(shift);
-                    renderer->draw(t->path);
-                    ofPopMatrix();
-                }
+        if (t->particles.size() < 2 || multiplierCount <= 0)
+            return;
+        
+        if (!t->path.isFilled()) {
+            instancer.draw(t->trail, t->path, multiplierCount);
+            return;
+        }
+        
+        for (int i = 0; i < multiplierCount; i++) {
+            if (i < shifts.size()) {
+                ofPushMatrix();
+                ofVec3f shift = shifts[i];
+                ofTranslate(shift);
+                renderer->draw(t->path);
+                ofPopMatrix();
             }
         }
     }
@@ -167,6 +237,9 @@ public:
     std::vector<ofVec3f> shifts;
     property<int> multiplierCount;
     property<float> maxShift;
+    
+private:
+    trail_instancer instancer;
 };
 
 class VibratingMultiplier : public TracerDrawStrategy {
@@ -176,7 +249,7 @@ public:
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
         entropy.clean();
         if (entropy > 0.1) {
-            super->shifts = super->getRandomShifts();
+            super->randomizeShifts(t);
         }
         
         super->draw(t, time, renderer);
@@ -187,20 +260,32 @@ private:
     property<float> entropy;
 };
 
+/*
+ * Given a shared batch, DrawPizza only queues its sprites and the owner flushes once per
+ * frame; tracer_system::draw() does that for its getSpriteBatch(). On its own it flushes a
+ * private batch after each tracer.
+ */
 class DrawPizza : public TracerDrawStrategy {
 public:
-    DrawPizza(ofImage& pizza) : pizza(pizza) {}
+    DrawPizza(ofImage& pizza) : pizza(pizza), batch(&ownBatch) {}
+    
+    DrawPizza(ofImage& pizza, sprite_batch& batch) : pizza(pizza), batch(&batch) {}
     
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
-        if (t->particles.size() > 0) {
-            for (Particle* particle : t->particles) {
-                pizza.draw(particle->location.x, particle->location.y);
-            }
+        ofTexture& texture = pizza.getTextureRef();
+        for (std::size_t i = 0; i < t->particles.size(); i++) {
+            ofVec3f const location = t->particles.getLocation(i);
+            batch->add(texture, location.x, location.y);
+        }
+        if (batch == &ownBatch) {
+            ownBatch.flush();
         }
     }
     
 private:
     ofImage& pizza;
+    sprite_batch ownBatch;
+    sprite_batch* batch;
 };
 
 class PerlinBrightness : public TracerDrawStrategy {
@@ -209,13 +294,33 @@ public:
     : timeShift(timeShift), velocity(velocity) {}
     
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
+        apply(t, ofNoise(getNoiseInput(time)));
+    }
+    
+    /* Same as draw() on each pair, with every noise lookup evaluated in one pass of noise, which the caller keeps so repeated draws don't allocate. */
+    static void draw(const std::vector<PerlinBrightness*>& strategies, const std::vector<Tracer*>& tracers, float time, noise_batch& noise) {
+        std::size_t const count = std::min(strategies.size(), tracers.size());
+        noise.clear();
+        for (std::size_t i = 0; i < count; i++) {
+            noise.add(strategies[i]->getNoiseInput(time));
+        }
+        noise.evaluate();
+        for (std::size_t i = 0; i < count; i++) {
+            strategies[i]->apply(tracers[i], noise[i]);
+        }
+    }
+    
+private:
+    float getNoiseInput(float time) const {
+        return time * velocity[0] + timeShift[0];
+    }
+    
+    void apply(Tracer* t, float noise) {
         ofColor color = t->path.getStrokeColor();
-        float noise = ofNoise(time * velocity[0] + timeShift[0]);
         color.setBrightness(ofMap(noise, 0, 1, 0, ofColor::limit(), true));
         t->path.setStrokeColor(color);
     }
     
-private:
     ofVec3f timeShift;
     ofVec3f velocity;
 };
@@ -368,7 +473,11 @@ class DrawPath : public TracerDrawStrategy {
 public:
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
         if (t->particles.size() >= 2) {
-            renderer->draw(t->path);
+            if (t->path.isFilled()) {
+                renderer->draw(t->path);
+            } else {
+                t->trail.draw(t->path);
+            }
         }
     }
 };
@@ -379,7 +488,7 @@ public:
     
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
         strokeWidth.clean();
-        Particle* head = t->getHead();
+        particle_ref head = t->getHead();
         if (head != nullptr) {
             ofPushMatrix();
             ofTranslate(head->location);
@@ -399,7 +508,7 @@ public:
     
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
         strokeWidth.clean();
-        Particle* head = t->getHead();
+        particle_ref head = t->getHead();
         if (head != nullptr) {
             ofDrawEllipse(head->location.x, head->location.y, head->location.z, strokeWidth, strokeWidth);
         }
@@ -414,7 +523,7 @@ public:
     
     void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
         strokeWidth.clean();
-        Particle* tail = t->getTail();
+        particle_ref tail = t->getTail();
         if (tail != nullptr) {
             ofDrawEllipse(tail->location.x, tail->location.y, tail->location.z, strokeWidth, strokeWidth);
         }
@@ -426,40 +535,40 @@ private:
 class HeadGrowth : public TracerUpdateStrategy {
 public:
     void update(Tracer* t, float time) {
-        t->particles.push_back(new Particle(t->head, ofVec3f::zero(), 0));
+        t->particles.push_back(t->head, ofVec3f::zero(), 0);
     }
 };
 
+/*
+ * Strokes only need the incremental trail, so for them path carries just the stroke style
+ * and no longer holds the curve; read the geometry from Tracer::trail. A filled path still
+ * gets its closed ofPath outline every update.
+ */
 class CurvedPath : public TracerUpdateStrategy {
 public:
-    CurvedPath() : updatesBeforeNextMoveTo(UPDATE_CYCLE) {}
-    
     void update(Tracer* t, float time) {
-        if (t->particles.size() >= 2 && updatesBeforeNextMoveTo-- > 0) {
-            updatesBeforeNextMoveTo = UPDATE_CYCLE;
+        t->trail.sync(t->particles, t->path.getCurveResolution());
+        if (t->path.isFilled() && t->particles.size() >= 2) {
             t->path.clear();
-            t->path.moveTo(t->particles[0]->location);
-            for (Particle* particle : t->particles) {
-                t->path.curveTo(particle->location);
+            t->path.moveTo(t->particles.getLocation(0));
+            for (std::size_t i = 0; i < t->particles.size(); i++) {
+                t->path.curveTo(t->particles.getLocation(i));
             }
         }
     }
-    
-private:
-    int const UPDATE_CYCLE = 5;
-    int updatesBeforeNextMoveTo;
 };
 
 class MaximumLength : public TracerUpdateStrategy {
 public:
     MaximumLength(property<int>& maxPoints): maxPoints("maxPoints", maxPoints) {}
     
-    void update(Tracer* t, float time) {
+    void clean() {
         maxPoints.clean();
+    }
+    
+    void update(Tracer* t, float time) {
         while (t->particles.size() > maxPoints) {
-            Particle* p = t->particles[0];
             t->particles.pop_front();
-            delete p;
         }
     }
 
@@ -514,38 +623,139 @@ public:
     }
 };
 
+/*
+ * The six side planes are read from the box once and cached until its size changes. Heads
+ * are tested against every cached plane in structure-of-arrays loops, keeping the original
+ * rule of taking the nearest crossing and, on a tie, the earlier side.
+ *
+ * clean() refreshes the cache on the owning thread and the single-tracer update() only reads
+ * it, so one instance can serve tracers updated in parallel. An update() that finds the cache
+ * not yet filled, because clean() has not run, fills it first under a lock, so calling the
+ * strategy without clean() still projects. The batch update() refreshes the cache itself,
+ * so like clean() it must only run on one thread at a time.
+ */
 class ProjectOntoBox : public TracerUpdateStrategy {
 public:
     ProjectOntoBox(ofBoxPrimitive* box) : box(box) {}
     
+    void clean() {
+        refreshPlanes();
+    }
+    
     void update(Tracer *t, float time) {
-        if (box->getSize().length() > 0) {
-            ofVec3f closestIntersection = MAX_INTERSECTION;
-            for (int i = 0; i < NUM_BOX_SIDES; i++) {
-                auto side = box->getSideMesh(i);
-                boxSide.set(side.getVertices()[0], side.getNormals()[0]);
-                line.set(ofVec3f(0, 0, 0), SCALE * t->head + JITTER);
-                intersection = is.LinePlaneIntersection(line, boxSide);
-                if (intersection.isIntersection) {
-                    if (intersection.pos.length() < closestIntersection.length()) {
-                        closestIntersection = intersection.pos;
-                    }
-                }
+        if (!isPlaneCacheValid.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(refreshMutex);
+            refreshPlanes();
+        }
+        if (cachedSize.length() <= 0)
+            return;
+        
+        float closestX = MAX_INTERSECTION.x;
+        float closestY = MAX_INTERSECTION.y;
+        float closestZ = MAX_INTERSECTION.z;
+        float closestLength = MAX_INTERSECTION.length();
+        project(&t->head.x, &t->head.y, &t->head.z, &closestX, &closestY, &closestZ, &closestLength, 1);
+        t->head += ofVec3f(closestX, closestY, closestZ);
+    }
+    
+    /* Same as update() on each tracer, projecting the heads in chunks small enough to stay in cache. */
+    void update(const std::vector<Tracer*>& tracers, float time) {
+        refreshPlanes();
+        if (cachedSize.length() <= 0)
+            return;
+        
+        float const maxLength = MAX_INTERSECTION.length();
+        float x[CHUNK], y[CHUNK], z[CHUNK];
+        float closestX[CHUNK], closestY[CHUNK], closestZ[CHUNK], closestLength[CHUNK];
+        for (std::size_t first = 0; first < tracers.size(); first += CHUNK) {
+            std::size_t const count = tracers.size() - first < CHUNK ? tracers.size() - first : CHUNK;
+            for (std::size_t i = 0; i < count; i++) {
+                ofVec3f const head = tracers[first + i]->head;
+                x[i] = head.x;
+                y[i] = head.y;
+                z[i] = head.z;
+                closestX[i] = MAX_INTERSECTION.x;
+                closestY[i] = MAX_INTERSECTION.y;
+                closestZ[i] = MAX_INTERSECTION.z;
+                closestLength[i] = maxLength;
+            }
+            project(x, y, z, closestX, closestY, closestZ, closestLength, count);
+            for (std::size_t i = 0; i < count; i++) {
+                tracers[first + i]->head += ofVec3f(closestX[i], closestY[i], closestZ[i]);
             }
-            t->head += closestIntersection;
         }
     }
     
 private:
+    void refreshPlanes() {
+        ofVec3f const size = box->getSize();
+        if (isPlaneCacheValid.load(std::memory_order_relaxed) && size == cachedSize)
+            return;
+        
+        for (int i = 0; i < NUM_BOX_SIDES; i++) {
+            auto side = box->getSideMesh(i);
+            planePoints[i] = side.getVertices()[0];
+            planeNormals[i] = side.getNormals()[0];
+        }
+        cachedSize = size;
+        isPlaneCacheValid.store(true, std::memory_order_release);
+    }
+    
+    /*
+     * Line from the origin through SCALE * head + JITTER against each plane, as
+     * ofxIntersection::LinePlaneIntersection() computes it. The planes are the inner loop, so
+     * each head's closest hit stays in registers and the loop over heads vectorizes.
+     */
+    void project(const float* __restrict hx, const float* __restrict hy, const float* __restrict hz,
+                 float* __restrict cx, float* __restrict cy, float* __restrict cz, float* __restrict cl,
+                 std::size_t count) const {
+        float nx[NUM_BOX_SIDES], ny[NUM_BOX_SIDES], nz[NUM_BOX_SIDES], numerators[NUM_BOX_SIDES];
+        for (int p = 0; p < NUM_BOX_SIDES; p++) {
+            nx[p] = planeNormals[p].x;
+            ny[p] = planeNormals[p].y;
+            nz[p] = planeNormals[p].z;
+            numerators[p] = planeNormals[p].dot(planePoints[p]);
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            float const dx = SCALE * hx[i] + JITTER;
+            float const dy = SCALE * hy[i] + JITTER;
+            float const dz = SCALE * hz[i] + JITTER;
+            float closestX = cx[i];
+            float closestY = cy[i];
+            float closestZ = cz[i];
+            float closestLength = cl[i];
+            for (int p = 0; p < NUM_BOX_SIDES; p++) {
+                float const denominator = nx[p] * dx + ny[p] * dy + nz[p] * dz;
+                float const u = numerators[p] / denominator;
+                float const px = u * dx;
+                float const py = u * dy;
+                float const pz = u * dz;
+                float const length = std::sqrt(px * px + py * py + pz * pz);
+                bool const isCloser = denominator != 0 && length < closestLength;
+                closestX = isCloser ? px : closestX;
+                closestY = isCloser ? py : closestY;
+                closestZ = isCloser ? pz : closestZ;
+                closestLength = isCloser ? length : closestLength;
+            }
+            cx[i] = closestX;
+            cy[i] = closestY;
+            cz[i] = closestZ;
+            cl[i] = closestLength;
+        }
+    }
+    
+    static int const NUM_BOX_SIDES = 6;
+    static std::size_t const CHUNK = 256;
+    
     ofBoxPrimitive* box;
     float const JITTER = 0.0001;
     int const SCALE = 100000;
-    int const NUM_BOX_SIDES = 6;
     ofVec3f const MAX_INTERSECTION = {INT_MAX, INT_MAX, INT_MAX};
-    ofxIntersection is;
-    IntersectionData intersection;
-    IsLine line;
-    IsPlane boxSide;
+    std::atomic<bool> isPlaneCacheValid = {false};
+    std::mutex refreshMutex;
+    ofVec3f cachedSize;
+    ofVec3f planePoints[NUM_BOX_SIDES];
+    ofVec3f planeNormals[NUM_BOX_SIDES];
 };
 
 class PerlinMovement : public TracerUpdateStrategy {
@@ -567,25 +777,56 @@ public:
         rangeZ("PerlinMovementRangeZ", rangeZ),
         timeShift(timeShift) {}
     
-    void update(Tracer* t, float time) {
+    void clean() {
         velocity.clean();
         rangeX.clean();
         rangeY.clean();
         rangeZ.clean();
-
-        float x = ofNoise(time * velocity[0] + timeShift[0]);
+    }
+    
+    void update(Tracer* t, float time) {
+        move(t,
+             ofNoise(time * velocity[0] + timeShift[0]),
+             ofNoise(time * velocity[1] + timeShift[1]),
+             ofNoise(time * velocity[2] + timeShift[2]));
+    }
+    
+    /* Same as update() on each tracer; the three noise lookups are the same for all of them, so they are made once, in noise. */
+    void update(const std::vector<Tracer*>& tracers, float time, noise_batch& noise) {
+        noise.clear();
+        for (int d = 0; d < 3; d++) {
+            noise.add(time * velocity[d] + timeShift[d]);
+        }
+        noise.evaluate();
+        for (Tracer* t : tracers) {
+            move(t, noise[0], noise[1], noise[2]);
+        }
+    }
+    
+    /* Same as update() on each pair, with all three noise lookups per tracer evaluated in one pass of noise, which the caller keeps so repeated updates don't allocate. */
+    static void update(const std::vector<PerlinMovement*>& strategies, const std::vector<Tracer*>& tracers, float time, noise_batch& noise) {
+        std::size_t const count = std::min(strategies.size(), tracers.size());
+        noise.clear();
+        for (std::size_t i = 0; i < count; i++) {
+            PerlinMovement* s = strategies[i];
+            for (int d = 0; d < 3; d++) {
+                noise.add(time * s->velocity[d] + s->timeShift[d]);
+            }
+        }
+        noise.evaluate();
+        for (std::size_t i = 0; i < count; i++) {
+            strategies[i]->move(tracers[i], noise[3 * i], noise[3 * i + 1], noise[3 * i + 2]);
+        }
+    }
+    
+private:
+    void move(Tracer* t, float x, float y, float z) {
         x = ofMap(x, 0, 1, rangeX[0], rangeX[1]);
-        
-        float y = ofNoise(time * velocity[1] + timeShift[1]);
         y = ofMap(y, 0, 1, rangeY[0], rangeY[1]);
-        
-        float z = ofNoise(time * velocity[2] + timeShift[2]);
         z = ofMap(z, 0, 1, rangeZ[0], rangeZ[1]);
-        
         t->head += ofVec3f(x, y, z);
     }
     
-private:
     property<ofVec3f> velocity;
     property<ofVec2f> rangeX;
     property<ofVec2f> rangeY;
@@ -597,8 +838,11 @@ class MapDimension : public TracerUpdateStrategy {
 public:
     MapDimension(int dimension, property<ofVec2f>& range) : dimension(dimension), range("MapDimensionRange", range) {}
     
-    void update(Tracer* t, float time) {
+    void clean() {
         range.clean();
+    }
+    
+    void update(Tracer* t, float time) {
         t->head[dimension] = ofMap(t->head[dimension], 0, 1, range[0], range[1]);
     }
     
@@ -0,0 +1,167 @@
+#ifndef tracer_pipeline_h
+#define tracer_pipeline_h
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "tracer.h"
+
+namespace ofxBenG {
+
+/* True when S has a batch update(const std::vector<Tracer*>&, float) alongside its per-tracer one. */
+template <typename S>
+class has_batch_update {
+    template <typename U>
+    static auto test(U* u) -> decltype(u->U::update(std::declval<const std::vector<Tracer*>&>(), 0.0f), std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+    static bool const value = decltype(test<S>(nullptr))::value;
+};
+
+/* True when S has a batch update that also takes a noise_batch to make its lookups in. */
+template <typename S>
+class has_noise_batch_update {
+    template <typename U>
+    static auto test(U* u) -> decltype(u->U::update(std::declval<const std::vector<Tracer*>&>(), 0.0f, std::declval<noise_batch&>()), std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+    static bool const value = decltype(test<S>(nullptr))::value;
+};
+
+/*
+ * A fixed chain of update strategies whose types are known at compile time. Each step is a
+ * qualified call, so the compiler binds it statically and can inline it instead of going
+ * through the vtable. The pipeline is itself a TracerUpdateStrategy, so it drops into the
+ * runtime list as one entry; update() over a batch runs each stage for every tracer
+ * before moving to the next stage, through the stage's own batch update() when it has one,
+ * such as ProjectOntoBox's or PerlinMovement's. Stages that look up noise share one
+ * noise_batch the pipeline keeps, so repeated batch updates don't allocate.
+ *
+ *     tracer_pipeline<PerlinMovement, MapDimension, HeadGrowth, MaximumLength> pipeline(&perlin, &map, &growth, &length);
+ */
+template <typename... Strategies>
+class tracer_pipeline : public TracerUpdateStrategy {
+public:
+    explicit tracer_pipeline(Strategies*... strategies) : strategies(strategies...) {}
+
+    void clean() {
+        cleanStep<0>();
+    }
+    
+    void update(Tracer* t, float time) {
+        step<0>(t, time);
+    }
+
+    /* Cleans the stages itself, so call it on the thread that owns their properties. */
+    void update(const std::vector<Tracer*>& tracers, float time) {
+        clean();
+        stage<0>(tracers, time);
+    }
+
+    template <std::size_t I>
+    typename std::tuple_element<I, std::tuple<Strategies*...>>::type get() {
+        return std::get<I>(strategies);
+    }
+
+private:
+    template <std::size_t I>
+    typename std::enable_if<(I < sizeof...(Strategies))>::type cleanStep() {
+        typedef typename std::tuple_element<I, std::tuple<Strategies...>>::type strategy_type;
+        std::get<I>(strategies)->strategy_type::clean();
+        cleanStep<I + 1>();
+    }
+
+    template <std::size_t I>
+    typename std::enable_if<(I == sizeof...(Strategies))>::type cleanStep() {}
+
+    template <std::size_t I>
+    typename std::enable_if<(I < sizeof...(Strategies))>::type step(Tracer* t, float time) {
+        typedef typename std::tuple_element<I, std::tuple<Strategies...>>::type strategy_type;
+        std::get<I>(strategies)->strategy_type::update(t, time);
+        step<I + 1>(t, time);
+    }
+
+    template <std::size_t I>
+    typename std::enable_if<(I == sizeof...(Strategies))>::type step(Tracer* t, float time) {}
+
+    template <std::size_t I>
+    typename std::enable_if<(I < sizeof...(Strategies))>::type stage(const std::vector<Tracer*>& tracers, float time) {
+        typedef typename std::tuple_element<I, std::tuple<Strategies...>>::type strategy_type;
+        typedef std::integral_constant<int, has_noise_batch_update<strategy_type>::value ? 2 : has_batch_update<strategy_type>::value ? 1 : 0> path;
+        runStage(std::get<I>(strategies), tracers, time, path());
+        stage<I + 1>(tracers, time);
+    }
+
+    template <std::size_t I>
+    typename std::enable_if<(I == sizeof...(Strategies))>::type stage(const std::vector<Tracer*>& tracers, float time) {}
+
+    template <typename S>
+    void runStage(S* strategy, const std::vector<Tracer*>& tracers, float time, std::integral_constant<int, 2>) {
+        strategy->S::update(tracers, time, noise);
+    }
+
+    template <typename S>
+    void runStage(S* strategy, const std::vector<Tracer*>& tracers, float time, std::integral_constant<int, 1>) {
+        strategy->S::update(tracers, time);
+    }
+
+    template <typename S>
+    void runStage(S* strategy, const std::vector<Tracer*>& tracers, float time, std::integral_constant<int, 0>) {
+        for (Tracer* t : tracers) {
+            strategy->S::update(t, time);
+        }
+    }
+
+    std::tuple<Strategies*...> strategies;
+    noise_batch noise;
+};
+
+/*
+ * Draw-side counterpart of tracer_pipeline. Draw strategies often share color state across
+ * tracers, so a batch still runs the whole chain per tracer.
+ */
+template <typename... Strategies>
+class tracer_draw_pipeline : public TracerDrawStrategy {
+public:
+    explicit tracer_draw_pipeline(Strategies*... strategies) : strategies(strategies...) {}
+
+    void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
+        step<0>(t, time, renderer);
+    }
+
+    void draw(const std::vector<Tracer*>& tracers, float time, std::shared_ptr<ofBaseRenderer> renderer) {
+        for (Tracer* t : tracers) {
+            step<0>(t, time, renderer);
+        }
+    }
+
+    template <std::size_t I>
+    typename std::tuple_element<I, std::tuple<Strategies*...>>::type get() {
+        return std::get<I>(strategies);
+    }
+
+private:
+    template <std::size_t I>
+    typename std::enable_if<(I < sizeof...(Strategies))>::type step(Tracer* t, float time, const std::shared_ptr<ofBaseRenderer>& renderer) {
+        typedef typename std::tuple_element<I, std::tuple<Strategies...>>::type strategy_type;
+        std::get<I>(strategies)->strategy_type::draw(t, time, renderer);
+        step<I + 1>(t, time, renderer);
+    }
+
+    template <std::size_t I>
+    typename std::enable_if<(I == sizeof...(Strategies))>::type step(Tracer* t, float time, const std::shared_ptr<ofBaseRenderer>& renderer) {}
+
+    std::tuple<Strategies*...> strategies;
+};
+
+} // ofxBenG
+
+#endif /* tracer_pipeline_h */
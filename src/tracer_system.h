@@ -0,0 +1,103 @@
+#ifndef tracer_system_h
+#define tracer_system_h
+
+#include <memory>
+#include <vector>
+#include "tracer.h"
+#include "work_stealing_pool.h"
+
+namespace ofxBenG {
+
+/*
+ * Owns a set of tracers and updates them in parallel chunks on a work-stealing pool. A
+ * tracer's update only touches that tracer and its own strategies, so tracers must not share
+ * strategy instances; given that, results do not depend on the thread count or the order
+ * chunks run in. Strategies' mirror properties are cleaned on the calling thread before the
+ * chunks are dealt out, so workers only ever read them. update() returns once every tracer is finished, so draw() on the render
+ * thread always sees complete geometry. Sprites queued on getSpriteBatch() while drawing are
+ * flushed at the end of draw(), so nothing queued during a frame is left behind.
+ */
+class tracer_system {
+public:
+    tracer_system(uint32_t seed = 0, std::size_t threads = std::thread::hardware_concurrency())
+        : seed(seed),
+          pool(threads) {}
+    
+    /* Takes ownership of the tracer and seeds it from the system seed and its index. */
+    Tracer* add(Tracer* tracer) {
+        tracer->setSeed(getSeed(tracers.size()));
+        tracers.emplace_back(tracer);
+        batch.push_back(tracer);
+        return tracer;
+    }
+    
+    /*
+     * Cleans every tracer's mirror properties here on the calling thread, then advances the
+     * tracers on the pool: each chunk runs its tracers' strategies and then integrates their
+     * particles as one batch. A pool of one thread would run every chunk here anyway, so it
+     * cleans and advances each tracer in one pass instead of walking all the strategies twice.
+     */
+    void update(float time) {
+        if (pool.getThreadCount() == 1) {
+            for (auto& tracer : tracers) {
+                tracer->update(time);
+            }
+            return;
+        }
+        for (auto& tracer : tracers) {
+            tracer->clean();
+        }
+        pool.parallelFor(batch.size(), CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                batch[i]->step(time);
+            }
+            Tracer::integrate(batch.data() + begin, end - begin);
+        });
+    }
+    
+    void draw(float time, std::shared_ptr<ofBaseRenderer> renderer) {
+        for (auto& tracer : tracers) {
+            tracer->draw(time, renderer);
+        }
+        sprites.flush();
+    }
+    
+    /* Shared batch for draw strategies such as DrawPizza; draw() flushes it once per frame. */
+    sprite_batch& getSpriteBatch() {
+        return sprites;
+    }
+    
+    Tracer* getTracer(std::size_t index) {
+        return tracers[index].get();
+    }
+    
+    std::size_t size() const {
+        return tracers.size();
+    }
+    
+    std::size_t getThreadCount() const {
+        return pool.getThreadCount();
+    }
+    
+private:
+    /* SplitMix32-style mix so neighbouring tracers get unrelated streams. */
+    uint32_t getSeed(std::size_t index) const {
+        uint32_t z = seed + 0x9E3779B9u * (uint32_t) (index + 1);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        return z ^ (z >> 16);
+    }
+    
+    static std::size_t const CHUNK_SIZE = 16;
+    
+    uint32_t seed;
+    std::vector<std::unique_ptr<Tracer>> tracers;
+    /* The same tracers, unowned, for batch calls such as Tracer::integrate(). */
+    std::vector<Tracer*> batch;
+    work_stealing_pool pool;
+    sprite_batch sprites;
+};
+
+} // ofxBenG
+
+#endif /* tracer_system_h */
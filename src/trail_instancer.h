@@ -0,0 +1,124 @@
+#ifndef trail_instancer_h
+#define trail_instancer_h
+
+#include <algorithm>
+#include <vector>
+#include "ofMain.h"
+#include "trail_mesh.h"
+
+namespace ofxBenG {
+
+/*
+ * Draws many translated copies of one trail. On the programmable renderer the offsets live in
+ * a per-instance vertex buffer and every copy goes out in a single instanced draw of the trail's
+ * VBO; otherwise the same VBO is drawn once per copy under a translation, so copies never cost
+ * CPU work or uploads per vertex.
+ */
+class trail_instancer {
+public:
+    enum mode {
+        AUTOMATIC,
+        INSTANCED,
+        TRANSLATED
+    };
+
+    void setMode(mode m) {
+        this->m = m;
+    }
+
+    /* Copies the offsets; the GPU buffer is refreshed on the next draw, and only reallocated when it has to grow. */
+    void setOffsets(const std::vector<ofVec3f>& offsets) {
+        this->offsets = offsets;
+        isOffsetBufferStale = true;
+    }
+
+    void draw(trail_mesh& trail, const ofPath& path, std::size_t instances) {
+        instances = std::min(instances, offsets.size());
+        if (trail.size() < 2 || instances == 0)
+            return;
+
+        ofPushStyle();
+        ofSetColor(path.getStrokeColor());
+        ofSetLineWidth(path.getStrokeWidth());
+        if (isInstanced()) {
+            drawInstanced(trail, instances);
+        } else {
+            drawTranslated(trail, instances);
+        }
+        ofPopStyle();
+    }
+
+private:
+    bool isInstanced() const {
+        return m == INSTANCED || (m == AUTOMATIC && ofIsGLProgrammableRenderer());
+    }
+
+    void drawInstanced(trail_mesh& trail, std::size_t instances) {
+        if (isOffsetBufferStale) {
+            if (offsets.size() > offsetBufferCapacity) {
+                offsetBuffer.allocate(offsets.size() * sizeof(ofVec3f), offsets.data(), GL_DYNAMIC_DRAW);
+                offsetBufferCapacity = offsets.size();
+            } else {
+                offsetBuffer.updateData(0, offsets.size() * sizeof(ofVec3f), offsets.data());
+            }
+            isOffsetBufferStale = false;
+        }
+
+        ofVbo& vbo = trail.getVbo();
+        vbo.setAttributeBuffer(OFFSET_ATTRIBUTE, offsetBuffer, 3, sizeof(ofVec3f));
+        vbo.setAttributeDivisor(OFFSET_ATTRIBUTE, 1);
+
+        ofShader& shader = getShader();
+        shader.begin();
+        vbo.drawInstanced(GL_LINE_STRIP, trail.getFirst(), trail.size(), instances);
+        shader.end();
+    }
+
+    void drawTranslated(trail_mesh& trail, std::size_t instances) {
+        ofVbo& vbo = trail.getVbo();
+        for (std::size_t i = 0; i < instances; i++) {
+            ofPushMatrix();
+            ofTranslate(offsets[i]);
+            vbo.draw(GL_LINE_STRIP, trail.getFirst(), trail.size());
+            ofPopMatrix();
+        }
+    }
+
+    static ofShader& getShader() {
+        static ofShader shader;
+        if (!shader.isLoaded()) {
+            shader.setupShaderFromSource(GL_VERTEX_SHADER,
+                "#version 150\n"
+                "uniform mat4 modelViewProjectionMatrix;\n"
+                "in vec4 position;\n"
+                "in vec3 offset;\n"
+                "void main() {\n"
+                "    gl_Position = modelViewProjectionMatrix * (position + vec4(offset, 0.0));\n"
+                "}\n");
+            shader.setupShaderFromSource(GL_FRAGMENT_SHADER,
+                "#version 150\n"
+                "uniform vec4 globalColor;\n"
+                "out vec4 outputColor;\n"
+                "void main() {\n"
+                "    outputColor = globalColor;\n"
+                "}\n");
+            shader.bindDefaults();
+            shader.bindAttribute(OFFSET_ATTRIBUTE, "offset");
+            shader.linkProgram();
+        }
+        return shader;
+    }
+
+    /* First attribute location after the ones ofShader::bindDefaults() reserves. */
+    static int const OFFSET_ATTRIBUTE = 4;
+
+    mode m = AUTOMATIC;
+    std::vector<ofVec3f> offsets;
+    bool isOffsetBufferStale = true;
+    ofBufferObject offsetBuffer;
+    std::size_t offsetBufferCapacity = 0;
+};
+
+} // ofxBenG
+
+#endif /* trail_instancer_h */
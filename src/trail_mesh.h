@@ -0,0 +1,159 @@
+#ifndef trail_mesh_h
+#define trail_mesh_h
+
+#include <vector>
+#include "ofMain.h"
+#include "particle_buffer.h"
+
+namespace ofxBenG {
+
+/*
+ * Catmull-Rom tessellation of a particle trail that is kept up to date incrementally:
+ * each sync() emits segments only for particles appended at the head and drops the
+ * segments of particles trimmed from the tail. Vertices stay contiguous in a sliding
+ * window that is compacted now and then, and only new vertices are uploaded to the GPU.
+ * If particles already in the trail have moved since the last sync(), the trail is
+ * rebuilt from scratch.
+ */
+class trail_mesh {
+public:
+    void sync(particle_buffer& particles, int resolution) {
+        uint64_t const popped = particles.getPoppedCount();
+        uint64_t const pushed = particles.getPushedCount();
+        if (resolution < 1)
+            resolution = 1;
+        if (resolution != this->resolution || popped >= nextSegment || particles.getMovedCount() != moved) {
+            reset(popped, resolution);
+            moved = particles.getMovedCount();
+        }
+
+        /*
+         * Segment s runs from particle s to s + 1 and needs s - 1 and s + 2 as control points.
+         * Like the ofPath it replaces, the strip starts at the tail particle and runs straight
+         * to the first segment, so the vertex just before the first live segment is rewritten
+         * to the current tail.
+         */
+        while (firstSegment <= popped && firstSegment < nextSegment) {
+            first += resolution;
+            firstSegment++;
+        }
+        if (size() > 0 && particles.size() > 0 && vertices[first] != particles.getLocation(0)) {
+            vertices[first] = particles.getLocation(0);
+            isLeadStale = true;
+        }
+
+        while (nextSegment + 2 < pushed) {
+            if (size() == 0)
+                vertices.push_back(particles.getLocation(0));
+            emitSegment(particles, nextSegment - popped);
+            nextSegment++;
+        }
+
+        if (first > compactThreshold && first * 2 > vertices.size()) {
+            vertices.erase(vertices.begin(), vertices.begin() + first);
+            first = 0;
+            uploaded = 0;
+            isBufferStale = true;
+        }
+    }
+
+    /* Draws the trail as one line strip in the stroke style of path. */
+    void draw(const ofPath& path) {
+        if (size() < 2)
+            return;
+        upload();
+        ofPushStyle();
+        ofSetColor(path.getStrokeColor());
+        ofSetLineWidth(path.getStrokeWidth());
+        vbo.draw(GL_LINE_STRIP, first, size());
+        ofPopStyle();
+    }
+
+    std::size_t size() const {
+        return vertices.size() - first;
+    }
+
+    const ofVec3f* data() const {
+        return vertices.data() + first;
+    }
+
+    ofVbo& getVbo() {
+        upload();
+        return vbo;
+    }
+
+    /* Offset of the first live vertex within getVbo(). */
+    std::size_t getFirst() const {
+        return first;
+    }
+
+private:
+    void reset(uint64_t popped, int resolution) {
+        vertices.clear();
+        first = 0;
+        uploaded = 0;
+        firstSegment = popped + 1;
+        nextSegment = popped + 1;
+        this->resolution = resolution;
+        isBufferStale = true;
+    }
+
+    /* Same points ofPolyline::curveTo() produces between particles i and i + 1, minus the shared start point. */
+    void emitSegment(particle_buffer& particles, std::size_t i) {
+        ofVec3f const p0 = particles.getLocation(i - 1);
+        ofVec3f const p1 = particles.getLocation(i);
+        ofVec3f const p2 = particles.getLocation(i + 1);
+        ofVec3f const p3 = particles.getLocation(i + 2);
+        for (int step = 1; step <= resolution; step++) {
+            float const t = (float) step / (float) resolution;
+            float const t2 = t * t;
+            float const t3 = t2 * t;
+            ofVec3f v;
+            for (int d = 0; d < 3; d++) {
+                v[d] = 0.5f * ((2.0f * p1[d])
+                        + (-p0[d] + p2[d]) * t
+                        + (2.0f * p0[d] - 5.0f * p1[d] + 4.0f * p2[d] - p3[d]) * t2
+                        + (-p0[d] + 3.0f * p1[d] - 3.0f * p2[d] + p3[d]) * t3);
+            }
+            vertices.push_back(v);
+        }
+    }
+
+    void upload() {
+        std::size_t const bytes = vertices.capacity() * sizeof(ofVec3f);
+        if (isBufferStale || bytes > allocatedBytes) {
+            allocatedBytes = bytes;
+            buffer.allocate(allocatedBytes, GL_DYNAMIC_DRAW);
+            vbo.setVertexBuffer(buffer, 3, sizeof(ofVec3f));
+            uploaded = 0;
+            isBufferStale = false;
+        }
+        if (isLeadStale && first < uploaded) {
+            buffer.updateData(first * sizeof(ofVec3f), sizeof(ofVec3f), vertices.data() + first);
+        }
+        isLeadStale = false;
+        if (uploaded < vertices.size()) {
+            buffer.updateData(uploaded * sizeof(ofVec3f), (vertices.size() - uploaded) * sizeof(ofVec3f), vertices.data() + uploaded);
+            uploaded = vertices.size();
+        }
+    }
+
+    static std::size_t const compactThreshold = 4096;
+
+    std::vector<ofVec3f> vertices;
+    std::size_t first = 0;
+    std::size_t uploaded = 0;
+    std::size_t allocatedBytes = 0;
+    uint64_t firstSegment = 0;
+    uint64_t nextSegment = 0;
+    uint64_t moved = 0;
+    int resolution = 0;
+    bool isBufferStale = true;
+    bool isLeadStale = false;
+    ofBufferObject buffer;
+    ofVbo vbo;
+};
+
+} // ofxBenG
+
+#endif /* trail_mesh_h */
@@ -0,0 +1,140 @@
+#ifndef value_cell_h
+#define value_cell_h
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace ofxBenG {
+
+    /*
+     * Triple buffer handing the latest value from writer threads to one reader. publish()
+     * fills a private slot and swaps it into the middle; consume() swaps the middle out only
+     * if something new arrived. Neither side ever sees a half-written value and the reader
+     * never waits.
+     *
+     * The last value published is also kept behind a seqlock, so writers can read-modify-write
+     * it and any thread can read it with getLatest() without taking a lock. A writer makes the
+     * sequence odd with one CAS while it works and even again when done; readers copy the
+     * value and retry if the sequence moved. With one writer, the usual one controller per
+     * property, nothing ever waits; a second writer only waits out the first one's copy.
+     */
+    template <typename T>
+    class value_cell {
+        static_assert(std::is_trivially_copyable<T>::value, "value_cell copies values word by word");
+
+    public:
+        value_cell() {
+            store(T());
+        }
+
+        /* Sets the value writers start from without handing anything to the reader. */
+        void seed(const T &value) {
+            unsigned const s = beginWrite();
+            store(value);
+            endWrite(s);
+        }
+
+        void publish(const T &value) {
+            unsigned const s = beginWrite();
+            store(value);
+            publishWritten(value);
+            endWrite(s);
+        }
+
+        /* Calls f on the last published value while holding off other writers; publishes it if f returns true. */
+        template <typename F>
+        bool update(F f) {
+            unsigned const s = beginWrite();
+            T value = load();
+            bool const changed = f(value);
+            if (changed) {
+                store(value);
+                publishWritten(value);
+            }
+            endWrite(s);
+            return changed;
+        }
+
+        /* The last value published by any writer, which the reader may not have consumed yet. Never blocks a writer. */
+        T getLatest() const {
+            while (true) {
+                unsigned const before = sequence.load(std::memory_order_acquire);
+                if ((before & 1) == 0) {
+                    T const value = load();
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence.load(std::memory_order_relaxed) == before)
+                        return value;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        /* Copies the newest value into value and returns true if one was published since the last call. */
+        bool consume(T &value) {
+            if ((middle.load(std::memory_order_acquire) & FRESH) == 0)
+                return false;
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+            value = slots[front];
+            return true;
+        }
+
+    private:
+        static std::size_t const WORDS = (sizeof(T) + sizeof(unsigned) - 1) / sizeof(unsigned);
+
+        /* Makes the sequence odd, waiting only for another writer to finish; returns the even value it started from. */
+        unsigned beginWrite() {
+            unsigned s = sequence.load(std::memory_order_relaxed);
+            while ((s & 1) != 0 || !sequence.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                if ((s & 1) != 0) {
+                    std::this_thread::yield();
+                    s = sequence.load(std::memory_order_relaxed);
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            return s;
+        }
+
+        void endWrite(unsigned s) {
+            sequence.store(s + 2, std::memory_order_release);
+        }
+
+        /* The latest value lives in atomic words so a reader racing a writer copies garbage it then discards, not undefined behavior. */
+        void store(const T &value) {
+            unsigned words[WORDS] = {};
+            std::memcpy(words, &value, sizeof(T));
+            for (std::size_t i = 0; i < WORDS; i++) {
+                latest[i].store(words[i], std::memory_order_relaxed);
+            }
+        }
+
+        T load() const {
+            unsigned words[WORDS];
+            for (std::size_t i = 0; i < WORDS; i++) {
+                words[i] = latest[i].load(std::memory_order_relaxed);
+            }
+            T value;
+            std::memcpy(&value, words, sizeof(T));
+            return value;
+        }
+
+        void publishWritten(const T &value) {
+            slots[back] = value;
+            back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+        }
+
+        static unsigned const INDEX = 3;
+        static unsigned const FRESH = 4;
+
+        T slots[3];
+        std::atomic<unsigned> latest[WORDS];
+        std::atomic<unsigned> sequence = {0};
+        std::atomic<unsigned> middle = {1};
+        unsigned back = 0;
+        unsigned front = 2;
+    };
+
+} // ofxBenG
+
+#endif /* value_cell_h */
@@ -1,52 +1,57 @@
 #include "video_stream.h"
 #include "window.h"
 #include "monitor.h"
+#include "blackmagic.h"
 
 using namespace ofxBenG;
 
 video_stream::video_stream(std::string deviceName, ofxPm::VideoGrabber *grabber, int defaultBufferSize)
         : deviceName(deviceName),
           grabber(grabber),
-          defaultBufferSize(defaultBufferSize),
-          currentlyRecording(nullptr) {
+          history(defaultBufferSize),
+          live(history) {
     screen = nullptr;
-    auto defaultBuffer = addBuffer();
-    recordInto(defaultBuffer);
+    blackMagic = dynamic_cast<BlackMagicVideoSource *>(grabber);
+    preview.setup(live);
 }
 
 video_stream::~video_stream() {
     std::cout << this->getDeviceName() << " is deleting" << std::endl;
+    history.finishCapture();
     if (screen != nullptr)
         delete screen;
-    for (auto buffer : buffers) {
-        buffer->stop();
-        buffer->clear();
-        delete buffer;
-    }
     grabber->close();
 }
 
 void video_stream::update() {
-    if (grabber != nullptr)
-        grabber->update();
+    if (grabber == nullptr)
+        return;
+
+    /* The worker reads the driver's pixels in place, so last frame's conversion ends before the driver reuses them. */
+    history.finishCapture();
+
+    /* Skip ofxPm's update(), which copies every frame into a VideoFrame and uploads it. */
+    if (blackMagic != nullptr) {
+        if (blackMagic->grab())
+            capture(blackMagic->getColorPixels());
+    } else {
+        grabber->ofVideoGrabber::update();
+        if (grabber->isFrameNew())
+            capture(grabber->getPixels());
+    }
+}
+
+void video_stream::capture(const ofPixels &pixels) {
+    if (pixels.isAllocated())
+        history.queueCapture(pixels, ofGetElapsedTimeMicros());
 }
 
 void video_stream::draw() {
-    if (currentlyRecording != nullptr) {
-        ofxPm::VideoFrame frame = currentlyRecording->getNextVideoFrame();
-        if (frame.isAllocated()) {
-            ofTexture &ref = frame.getTextureRef();
-            ref.draw(0, 0);
-        }
-    }
+    preview.draw(0, 0, getSize()[0], getSize()[1]);
 }
 
 float video_stream::getFps() {
-    if (buffers.size() > 0) {
-        return buffers[0]->getRealFPS();
-    } else {
-        return 0;
-    }
+    return live.getFps();
 }
 
 void video_stream::setWindow(ofxBenG::window *window) {
@@ -57,35 +62,22 @@ ofxBenG::window *video_stream::getWindow() {
     return screen;
 }
 
-int video_stream::addBuffer() {
-    auto buffer = new ofxPm::VideoBuffer();
-    buffer->setup(*grabber, defaultBufferSize, false);
-    buffers.push_back(buffer);
-    return buffers.size() - 1;
+frame_window *video_stream::makeWindow() {
+    return new frame_window(history);
 }
 
-ofxPm::VideoBuffer *video_stream::makeBuffer(int size) {
-    auto buffer = new ofxPm::VideoBuffer();
-    buffer->setup(*grabber, size, false);
-    return buffer;
+frame_header *video_stream::makeHeader() {
+    auto header = new frame_header;
+    header->setup(live);
+    return header;
 }
 
-void video_stream::recordInto(int i) {
-    if (i > buffers.size() || i < 0)
-        return;
-
-    if (currentlyRecording != nullptr)
-        currentlyRecording->stop();
-
-    auto buffer = buffers[i];
-    buffer->resume();
-    currentlyRecording = buffer;
+frame_history &video_stream::getHistory() {
+    return history;
 }
 
-ofxPm::VideoHeader *video_stream::makeHeader(int i) {
-    auto header = new ofxPm::VideoHeader;
-    header->setup(*buffers[i]);
-    return header;
+bool video_stream::spillTo(const std::string &file, int frames) {
+    return frames > 0 && history.setSpill(file, frames);
 }
 
 std::string video_stream::getDeviceName() {
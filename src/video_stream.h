@@ -2,10 +2,20 @@
 #define VIDEO_STREAM_H
 
 #include "ofxPlaymodes.h"
+#include "frame_history.h"
 
 namespace ofxBenG {
     class window;
     class monitor;
+    class BlackMagicVideoSource;
+
+    /*
+     * One capture device. Each new frame is copied once into the stream's frame_history;
+     * windows, headers and flickers all read that one copy, and textures are only uploaded
+     * by the frame_headers that draw. The copy, a conversion to YUV 4:2:0, runs on the
+     * history's worker thread while the frame renders, and the frame joins the history at
+     * the next update(), one frame later.
+     */
     class video_stream {
     public:
         video_stream(std::string deviceName, ofxPm::VideoGrabber *grabber, int defaultBufferSize);
@@ -22,24 +32,30 @@ namespace ofxBenG {
 
         ofxBenG::window *getWindow();
 
-        int addBuffer();
+        /* A new window over this stream's history; the caller owns it. */
+        frame_window *makeWindow();
 
-        ofxPm::VideoBuffer *makeBuffer(int size);
+        /* A new header showing the live stream; the caller owns it. */
+        frame_header *makeHeader();
 
-        void recordInto(int i);
+        frame_history &getHistory();
 
-        ofxPm::VideoHeader *makeHeader(int i);
+        /* Extends the history by frames kept compressed on disk in file. False if it could not be created. */
+        bool spillTo(const std::string &file, int frames);
 
         std::string getDeviceName();
 
         ofVec2f getSize();
 
     private:
+        void capture(const ofPixels &pixels);
+
         ofxPm::VideoGrabber *grabber;
-        ofxPm::VideoBuffer *currentlyRecording;
+        BlackMagicVideoSource *blackMagic;
+        frame_history history;
+        frame_window live;
+        frame_header preview;
         std::string deviceName;
-        std::vector<ofxPm::VideoBuffer *> buffers;
-        int defaultBufferSize;
         ofxBenG::window *screen;
     };
 }
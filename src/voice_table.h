@@ -0,0 +1,98 @@
+#ifndef voice_table_h
+#define voice_table_h
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+
+namespace ofxBenG {
+
+    /*
+     * Fixed-capacity table of voice pointers shared between control threads and the audio
+     * callback. Every slot is an atomic pointer, so adding and removing is a CAS on one slot
+     * and the audio thread can walk the table at any time without a lock or a torn container.
+     *
+     * Any thread may remove, but only one thread may ever add: checking for a voice and
+     * claiming a free slot are two steps, so two adders could each put the same voice in a
+     * different slot. Debug builds assert that a second thread never adds.
+     */
+    template <typename T, std::size_t Capacity>
+    class voice_table {
+    public:
+        voice_table() {
+            for (auto &slot : slots)
+                slot.store(nullptr, std::memory_order_relaxed);
+        }
+
+        bool add(T *voice) {
+            assertAdder();
+            if (contains(voice))
+                return true;
+
+            for (std::size_t i = 0; i < Capacity; i++) {
+                T *expected = nullptr;
+                if (slots[i].compare_exchange_strong(expected, voice, std::memory_order_acq_rel)) {
+                    raiseHighWater(i + 1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool remove(T *voice) {
+            for (std::size_t i = 0; i < Capacity; i++) {
+                T *expected = voice;
+                if (slots[i].compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel))
+                    return true;
+            }
+            return false;
+        }
+
+        bool contains(T *voice) {
+            std::size_t const end = getHighWater();
+            for (std::size_t i = 0; i < end; i++) {
+                if (slots[i].load(std::memory_order_acquire) == voice)
+                    return true;
+            }
+            return false;
+        }
+
+        /* Slot i's voice, or nullptr if the slot is free. */
+        T *get(std::size_t i) {
+            return slots[i].load(std::memory_order_acquire);
+        }
+
+        /* Makes the calling thread the adder, e.g. when a restarted audio stream calls back on a new thread. */
+        void relatchAdder() {
+            adder.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        }
+
+        /* One past the highest slot that has ever held a voice. */
+        std::size_t getHighWater() {
+            return highWater.load(std::memory_order_acquire);
+        }
+
+        static std::size_t const capacity = Capacity;
+
+    private:
+        void assertAdder() {
+            std::thread::id owner;
+            adder.compare_exchange_strong(owner, std::this_thread::get_id(), std::memory_order_relaxed);
+            assert(owner == std::thread::id() || owner == std::this_thread::get_id());
+        }
+
+        void raiseHighWater(std::size_t value) {
+            std::size_t current = highWater.load(std::memory_order_relaxed);
+            while (current < value && !highWater.compare_exchange_weak(current, value, std::memory_order_acq_rel)) {
+            }
+        }
+
+        std::atomic<T *> slots[Capacity];
+        std::atomic<std::size_t> highWater = {0};
+        std::atomic<std::thread::id> adder = {std::thread::id()};
+    };
+
+} // ofxBenG
+
+#endif /* voice_table_h */
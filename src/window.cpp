@@ -5,7 +5,6 @@ using namespace ofxBenG;
 
 window::window(std::shared_ptr<ofAppBaseWindow> parentWindow, bool startFullscreen)
         : parentWindow(parentWindow), startFullscreen(startFullscreen) {
-    renderer = nullptr;
     header = nullptr;
     monitor = nullptr;
     stream = nullptr;
@@ -25,8 +24,6 @@ void window::close() {
         if (stream != nullptr)
             stream->setWindow(nullptr);
         stream = nullptr;
-        if (renderer != nullptr)
-            delete renderer;
         if (header != nullptr)
             delete header;
         myWindow->setWindowShouldClose();
@@ -52,7 +49,7 @@ void window::setStream(ofxBenG::video_stream* stream) {
     if (stream != nullptr) {
         this->stream = stream;
         std::cout << "Setting " << this->stream->getDeviceName() << " to window of " << this->getMonitorName() << std::endl;
-        header = stream->makeHeader(0);
+        header = stream->makeHeader();
         this->addView(new header_view(header));
         this->stream->setWindow(this);
     }
@@ -45,8 +45,7 @@ namespace ofxBenG {
         ofxBenG::video_stream *getStream();
 
     private:
-        ofxPm::VideoHeader *header;
-        ofxPm::BasicVideoRenderer *renderer;
+        ofxBenG::frame_header *header;
         ofxBenG::video_stream *stream;
         ofxBenG::monitor *monitor;
         shared_ptr<ofAppBaseWindow> myWindow;
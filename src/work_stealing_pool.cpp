@@ -0,0 +1,110 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+using namespace ofxBenG;
+
+work_stealing_pool::work_stealing_pool(std::size_t threads) {
+    if (threads == 0)
+        threads = 1;
+    for (std::size_t i = 0; i < threads; i++) {
+        queues.emplace_back(new range_queue());
+    }
+    /* The last queue belongs to the thread calling parallelFor(). */
+    for (std::size_t i = 0; i + 1 < threads; i++) {
+        workers.emplace_back(&work_stealing_pool::workerLoop, this, i);
+    }
+}
+
+work_stealing_pool::~work_stealing_pool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+std::size_t work_stealing_pool::getThreadCount() const {
+    return queues.size();
+}
+
+void work_stealing_pool::parallelFor(std::size_t count, std::size_t chunkSize, const range_function &body) {
+    if (count == 0)
+        return;
+    if (chunkSize == 0)
+        chunkSize = 1;
+
+    std::size_t const chunks = (count + chunkSize - 1) / chunkSize;
+    if (workers.empty() || chunks == 1) {
+        body(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->body = &body;
+        remaining.store(chunks, std::memory_order_relaxed);
+        for (std::size_t c = 0; c < chunks; c++) {
+            range_queue &queue = *queues[c % queues.size()];
+            std::lock_guard<std::mutex> queueLock(queue.mutex);
+            queue.ranges.push_back({c * chunkSize, std::min(count, (c + 1) * chunkSize)});
+        }
+        generation++;
+    }
+    wake.notify_all();
+
+    drain(queues.size() - 1);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return remaining.load(std::memory_order_acquire) == 0; });
+    this->body = nullptr;
+}
+
+void work_stealing_pool::workerLoop(std::size_t self) {
+    std::size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return isStopping || generation != seen; });
+            if (isStopping)
+                return;
+            seen = generation;
+        }
+        drain(self);
+    }
+}
+
+void work_stealing_pool::drain(std::size_t self) {
+    range r;
+    while (popOrSteal(self, r)) {
+        (*body)(r.begin, r.end);
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
+
+bool work_stealing_pool::popOrSteal(std::size_t self, range &r) {
+    {
+        range_queue &own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.ranges.empty()) {
+            r = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+    for (std::size_t i = 1; i < queues.size(); i++) {
+        range_queue &victim = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.ranges.empty()) {
+            r = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,64 @@
+#ifndef work_stealing_pool_h
+#define work_stealing_pool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ofxBenG {
+
+    /*
+     * Fixed set of worker threads for data-parallel loops. parallelFor() deals chunks of the
+     * index range round-robin onto per-thread deques; each thread drains its own deque from
+     * the back and, once empty, steals from the front of the others. The calling thread
+     * works too and the call returns when every chunk has run.
+     */
+    class work_stealing_pool {
+    public:
+        typedef std::function<void(std::size_t begin, std::size_t end)> range_function;
+
+        explicit work_stealing_pool(std::size_t threads = std::thread::hardware_concurrency());
+
+        ~work_stealing_pool();
+
+        void parallelFor(std::size_t count, std::size_t chunkSize, const range_function &body);
+
+        /* Threads that run chunks, counting the caller of parallelFor(). */
+        std::size_t getThreadCount() const;
+
+    private:
+        struct range {
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        struct range_queue {
+            std::mutex mutex;
+            std::deque<range> ranges;
+        };
+
+        void workerLoop(std::size_t self);
+
+        void drain(std::size_t self);
+
+        bool popOrSteal(std::size_t self, range &r);
+
+        std::vector<std::unique_ptr<range_queue>> queues;
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const range_function *body = nullptr;
+        std::size_t generation = 0;
+        std::atomic<std::size_t> remaining = {0};
+        bool isStopping = false;
+    };
+
+} // ofxBenG
+
+#endif /* work_stealing_pool_h */
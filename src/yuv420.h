@@ -0,0 +1,197 @@
+#ifndef yuv420_h
+#define yuv420_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "ofMain.h"
+
+namespace ofxBenG {
+
+    /*
+     * Planar YUV 4:2:0 storage for recorded frames: 12 bits a pixel against 32 for the RGBA
+     * a BlackMagic card delivers. Uses BT.601 studio-swing coefficients in 8.8 fixed point.
+     * Both directions work a row at a time through contiguous 16-bit arrays so the compiler
+     * vectorizes the arithmetic, eight lanes to an SSE2 register. Frames need even
+     * dimensions; anything else is stored as is.
+     */
+    class yuv420 {
+    public:
+        static bool isPlanar(ofPixelFormat format) {
+            return format == OF_PIXELS_I420 || format == OF_PIXELS_YV12;
+        }
+
+        static bool canConvert(const ofPixels &pixels) {
+            ofPixelFormat const format = pixels.getPixelFormat();
+            return (pixels.getWidth() % 2) == 0 && (pixels.getHeight() % 2) == 0 &&
+                   (format == OF_PIXELS_RGB || format == OF_PIXELS_RGBA || format == OF_PIXELS_BGRA);
+        }
+
+        /* Copies from into to, converting packed RGB(A) to I420 on the way. */
+        static void store(const ofPixels &from, ofPixels &to) {
+            bool const convert = canConvert(from);
+            ofPixelFormat const format = convert ? OF_PIXELS_I420 : from.getPixelFormat();
+            if (to.getWidth() != from.getWidth() || to.getHeight() != from.getHeight() || to.getPixelFormat() != format) {
+                to.allocate(from.getWidth(), from.getHeight(), format);
+            }
+            if (!convert) {
+                std::memcpy(to.getData(), from.getData(), from.getTotalBytes());
+                return;
+            }
+
+            std::size_t const width = from.getWidth();
+            std::size_t const height = from.getHeight();
+            std::size_t const channels = from.getNumChannels();
+            bool const isBgr = from.getPixelFormat() == OF_PIXELS_BGRA;
+            uint8_t *y = to.getData();
+            uint8_t *u = y + width * height;
+            uint8_t *v = u + (width / 2) * (height / 2);
+            fromRgb(from.getData(), channels, isBgr, width, height, y, u, v);
+        }
+
+        /* Converts an I420 or YV12 frame to packed RGB. */
+        static void toRgb(const ofPixels &from, ofPixels &to) {
+            std::size_t const width = from.getWidth();
+            std::size_t const height = from.getHeight();
+            if (to.getWidth() != width || to.getHeight() != height || to.getPixelFormat() != OF_PIXELS_RGB) {
+                to.allocate(width, height, OF_PIXELS_RGB);
+            }
+            const uint8_t *y = from.getData();
+            const uint8_t *u = y + width * height;
+            const uint8_t *v = u + (width / 2) * (height / 2);
+            if (from.getPixelFormat() == OF_PIXELS_YV12) {
+                std::swap(u, v);
+            }
+            toRgb(y, u, v, width, height, to.getData());
+        }
+
+        static void fromRgb(const uint8_t *rgb, std::size_t channels, bool isBgr, std::size_t width, std::size_t height,
+                            uint8_t *y, uint8_t *u, uint8_t *v) {
+            std::size_t const half = width / 2;
+            std::vector<uint16_t> first(width * 2), second(width * 2), third(width * 2);
+            std::vector<uint16_t> first2(half), second2(half), third2(half);
+            /* Channels are split in memory order; BGRA just swaps which array is red. */
+            const uint16_t *red = isBgr ? third.data() : first.data();
+            const uint16_t *blue = isBgr ? first.data() : third.data();
+            const uint16_t *red2 = isBgr ? third2.data() : first2.data();
+            const uint16_t *blue2 = isBgr ? first2.data() : third2.data();
+
+            for (std::size_t row = 0; row < height; row += 2) {
+                /* Deinterleave two rows so the arithmetic below runs over plain arrays. */
+                deinterleave(rgb + row * width * channels, channels, first.data(), second.data(), third.data(), width * 2);
+                luma(red, second.data(), blue, y + row * width, width * 2);
+
+                /* Chroma of each 2x2 block, from its average color. */
+                average(first.data(), first.data() + width, first2.data(), half);
+                average(second.data(), second.data() + width, second2.data(), half);
+                average(third.data(), third.data() + width, third2.data(), half);
+                chroma(red2, second2.data(), blue2, u + (row / 2) * half, v + (row / 2) * half, half);
+            }
+        }
+
+        static void toRgb(const uint8_t *y, const uint8_t *u, const uint8_t *v, std::size_t width, std::size_t height, uint8_t *rgb) {
+            std::size_t const half = width / 2;
+            std::vector<int16_t> blueDifference(width), redDifference(width);
+            std::vector<uint8_t> red(width), green(width), blue(width);
+
+            for (std::size_t row = 0; row < height; row++) {
+                if ((row % 2) == 0) {
+                    upsample(u + (row / 2) * half, v + (row / 2) * half, blueDifference.data(), redDifference.data(), half);
+                }
+                rgbRow(y + row * width, blueDifference.data(), redDifference.data(), red.data(), green.data(), blue.data(), width);
+
+                uint8_t *out = rgb + row * width * 3;
+                for (std::size_t x = 0; x < width; x++) {
+                    out[3 * x] = red[x];
+                    out[3 * x + 1] = green[x];
+                    out[3 * x + 2] = blue[x];
+                }
+            }
+        }
+
+    private:
+        /* A constant stride lets the compiler vectorize the common packings. */
+        template <std::size_t CHANNELS>
+        static void deinterleave(const uint8_t *__restrict rgb, uint16_t *__restrict first, uint16_t *__restrict second,
+                                 uint16_t *__restrict third, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                first[i] = rgb[i * CHANNELS];
+                second[i] = rgb[i * CHANNELS + 1];
+                third[i] = rgb[i * CHANNELS + 2];
+            }
+        }
+
+        static void deinterleave(const uint8_t *rgb, std::size_t channels, uint16_t *first, uint16_t *second, uint16_t *third, std::size_t count) {
+            if (channels == 4) {
+                deinterleave<4>(rgb, first, second, third, count);
+            } else if (channels == 3) {
+                deinterleave<3>(rgb, first, second, third, count);
+            } else {
+                for (std::size_t i = 0; i < count; i++) {
+                    first[i] = rgb[i * channels];
+                    second[i] = rgb[i * channels + 1];
+                    third[i] = rgb[i * channels + 2];
+                }
+            }
+        }
+
+        /* The weighted sum peaks at 56228, so it stays in 16-bit lanes. */
+        static void luma(const uint16_t *__restrict red, const uint16_t *__restrict green, const uint16_t *__restrict blue,
+                         uint8_t *__restrict y, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                y[i] = (uint8_t) (((uint16_t) (66 * red[i] + 129 * green[i] + 25 * blue[i] + 128) >> 8) + 16);
+            }
+        }
+
+        /* Rounded mean of each 2x2 block, given its top and bottom rows. */
+        static void average(const uint16_t *__restrict top, const uint16_t *__restrict bottom, uint16_t *__restrict out, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                out[i] = (uint16_t) (top[2 * i] + top[2 * i + 1] + bottom[2 * i] + bottom[2 * i + 1] + 2) >> 2;
+            }
+        }
+
+        /* Both sums stay within +-28688, so they fit signed 16-bit lanes. */
+        static void chroma(const uint16_t *__restrict red, const uint16_t *__restrict green, const uint16_t *__restrict blue,
+                           uint8_t *__restrict u, uint8_t *__restrict v, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                int16_t const r = red[i], g = green[i], b = blue[i];
+                u[i] = (uint8_t) (((int16_t) (-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                v[i] = (uint8_t) (((int16_t) (112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+
+        /* Centered chroma for one row pair, upsampled to full width. */
+        static void upsample(const uint8_t *__restrict u, const uint8_t *__restrict v,
+                             int16_t *__restrict blueDifference, int16_t *__restrict redDifference, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                blueDifference[2 * i] = blueDifference[2 * i + 1] = (int16_t) (u[i] - 128);
+                redDifference[2 * i] = redDifference[2 * i + 1] = (int16_t) (v[i] - 128);
+            }
+        }
+
+        /*
+         * (298c + 409e + 128) >> 8 and its siblings, with each multiplier split into a multiple
+         * of 256 and a remainder: the multiple comes out of the shift whole, and what goes into
+         * it stays under 2^15, so the same results come from 16-bit lanes instead of 32-bit ones.
+         */
+        static void rgbRow(const uint8_t *__restrict y, const int16_t *__restrict blueDifference, const int16_t *__restrict redDifference,
+                           uint8_t *__restrict red, uint8_t *__restrict green, uint8_t *__restrict blue, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                int16_t const c = (int16_t) (y[i] - 16);
+                int16_t const d = blueDifference[i];
+                int16_t const e = redDifference[i];
+                int16_t const rest = (int16_t) (42 * c + 128);
+                red[i] = clamp((int16_t) (c + e + ((int16_t) (rest + 153 * e) >> 8)));
+                green[i] = clamp((int16_t) (c - e + ((int16_t) (rest + 48 * e - 100 * d) >> 8)));
+                blue[i] = clamp((int16_t) (c + 2 * d + ((int16_t) (rest + 4 * d) >> 8)));
+            }
+        }
+
+        static uint8_t clamp(int16_t value) {
+            return (uint8_t) std::min<int16_t>(std::max<int16_t>(value, 0), 255);
+        }
+    };
+}
+
+#endif /* yuv420_h */
@@ -0,0 +1,151 @@
+/*
+ * Drives a real beat_action tree through a few hundred frames: every frame the root
+ * schedules generic_actions, cues a play_tone and cues a child that schedules on its own
+ * beat and time wheels, the tree fires and retires whatever is due, and the audio thread's
+ * side is rendered in step so tones start, stop and come back for deletion. Fails if any
+ * steady-state frame reaches the global operator new. Counts
+ * every allocation in the process, not just action_pool growth. Build against
+ * openFrameworks with the addon and its dependencies and run.
+ */
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include "beat_action.h"
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations++;
+    void *p = std::malloc(size > 0 ? size : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using namespace ofxBenG;
+
+static int const WARM_UP_FRAMES = 400;
+static int const FRAMES = 300;
+static int const CUES_PER_FRAME = 40;
+static float const TEMPO = 120;
+static float const FPS = 30;
+
+/* A short-lived child that schedules, so every frame a fresh action's wheels take their slots and give them back. */
+class scheduling_child : public beat_action {
+public:
+    scheduling_child(float *fired) : fired(fired) {
+    }
+
+    virtual std::string getLabel() {
+        return "Scheduling child";
+    }
+
+    virtual void startThisAction() {
+        float *total = fired;
+        schedule(0.5f, [total]() { *total += 1; });
+        cueInSeconds(0.1f, [total]() { *total += 1; });
+    }
+
+    virtual void updateThisAction() {
+    }
+
+private:
+    float *fired;
+};
+
+/* Schedules its cues from inside the tree's update, where getClock() is the frame's clock. */
+class cue_source : public beat_action {
+public:
+    cue_source() {
+        /* The same spread of offsets every frame, so the number of live actions levels off after warming up. */
+        std::mt19937 random(3);
+        std::uniform_real_distribution<float> offsets(0, 8);
+        for (float &offset : beatsAhead) {
+            offset = offsets(random);
+        }
+    }
+
+    virtual std::string getLabel() {
+        return "Cue source";
+    }
+
+    virtual void startThisAction() {
+    }
+
+    virtual void updateThisAction() {
+        if (!isBoxedCued) {
+            /* A capture bigger than action_function's buffer still runs; it is boxed on the heap. */
+            std::array<double, 16> big;
+            big.fill(1);
+            double *ran = &oversized;
+            cue([big, ran]() { *ran = big[15]; });
+            isBoxedCued = true;
+        }
+        for (int i = 0; i < CUES_PER_FRAME; i++) {
+            float const weight = (float) i;
+            float *total = &fired;
+            schedule(beatsAhead[i], [total, weight]() { *total += weight; });
+        }
+        cue(new play_tone(0.25f, 440));
+        cue(new scheduling_child(&childFired));
+    }
+
+    virtual bool isThisActionDone() {
+        return false;
+    }
+
+    float fired = 0;
+    float childFired = 0;
+    double oversized = 0;
+
+private:
+    bool isBoxedCued = false;
+    std::array<float, CUES_PER_FRAME> beatsAhead;
+};
+
+static uint64_t now = 0;
+
+int main() {
+    audio *a = audio::getInstance();
+    a->setMicrosecondsSource([] { return now; });
+    float buffer[audio::bufferSize];
+    double const callbackMicroseconds = audio::bufferSize * 1e6 / audio::rate;
+    double nextCallback = 0;
+
+    cue_source root;
+    std::size_t steadyAllocations = 0;
+    for (int frame = 0; frame < WARM_UP_FRAMES + FRAMES; frame++) {
+        now = (uint64_t) (frame * 1e6 / FPS);
+        frame_clock clock;
+        clock.microseconds = now;
+        clock.tempo = TEMPO;
+        clock.beat = (float) (now * TEMPO / 60e6);
+        clock.phase = clock.beat - std::floor(clock.beat);
+
+        std::size_t const before = allocations;
+        root.update(clock);
+        while (nextCallback <= now) {
+            a->process(buffer, audio::bufferSize, 1);
+            nextCallback += callbackMicroseconds;
+        }
+        if (frame >= WARM_UP_FRAMES)
+            steadyAllocations += allocations - before;
+    }
+
+    /* Every child but the last few, still waiting when the run ends, fired both of its schedules. */
+    bool const childrenFired = root.childFired >= 2 * (WARM_UP_FRAMES + FRAMES - FPS);
+    std::printf("action allocations: %zu in %d steady-state frames (action_pool grew %zu times in all, oversized capture ran: %s, children's schedules fired: %.0f)\n",
+                steadyAllocations, FRAMES, action_pool::getHeapAllocations(), root.oversized == 1 ? "yes" : "no", root.childFired);
+    return steadyAllocations == 0 && root.oversized == 1 && childrenFired ? 0 : 1;
+}
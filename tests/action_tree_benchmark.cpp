@@ -0,0 +1,71 @@
+/*
+ * Updates a root beat_action with 1,000 running children that all read the beat every
+ * frame, and compares the cost of the one Link query the tree now makes per frame with
+ * the 1,000 it made when every action asked ableton() for the beat itself. Needs
+ * openFrameworks and ofxAbletonLink.
+ */
+#include <chrono>
+#include <cstdio>
+#include "beat_action.h"
+
+using namespace ofxBenG;
+
+class reading_action : public beat_action {
+public:
+    virtual std::string getLabel() {
+        return "Reading";
+    }
+
+    virtual void startThisAction() {
+    }
+
+    virtual void updateThisAction() {
+        sum += getClock().beat;
+    }
+
+    virtual bool isThisActionDone() {
+        return false;
+    }
+
+    static float sum;
+};
+
+float reading_action::sum = 0;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static double microsecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+}
+
+static int const ACTIONS = 1000;
+static int const FRAMES = 600;
+
+int main() {
+    ableton()->setup(120, 4);
+    reading_action root;
+    root.start();
+    for (int i = 0; i < ACTIONS; i++) {
+        root.cue(new reading_action());
+    }
+
+    double treeMicroseconds = 0;
+    double queryMicroseconds = 0;
+    volatile float sink = 0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        benchmark_clock::time_point start = benchmark_clock::now();
+        root.update(ableton()->getFrameClock());
+        treeMicroseconds += microsecondsSince(start);
+
+        /* What the tree paid on top before: one getBeat() Link query per action reading the beat. */
+        start = benchmark_clock::now();
+        for (int i = 0; i < ACTIONS; i++) {
+            sink = ableton()->getBeat();
+        }
+        queryMicroseconds += microsecondsSince(start);
+    }
+
+    std::printf("%d running actions: tree update %.1f us/frame with 1 Link query\n", ACTIONS, treeMicroseconds / FRAMES);
+    std::printf("per-action Link queries, as before: +%.1f us/frame for %d queries\n", queryMicroseconds / FRAMES, ACTIONS);
+    return 0;
+}
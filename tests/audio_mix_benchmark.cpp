@@ -0,0 +1,101 @@
+/*
+ * Renders 64 sawtooth voices, each a block mix, through audio::process() one 512-frame
+ * callback at a time, and compares it with the per-sample loop getMix() used to run, which
+ * called every voice's per-sample function and summed it for one frame before moving to the
+ * next, and with getMix() as it is now. Needs openFrameworks and ofxMaxim.
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "audio.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static double nanosecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(benchmark_clock::now() - start).count();
+}
+
+static int const VOICES = 64;
+static int const FRAMES = audio::bufferSize;
+static int const CALLBACKS = 2000;
+
+int main() {
+    audio *a = audio::getInstance();
+    std::vector<mix_t*> voices;
+    std::vector<MixFunction> perSample;
+    std::vector<float> phases(VOICES);
+    std::vector<float> perSamplePhases(VOICES);
+    for (int v = 0; v < VOICES; v++) {
+        float const increment = (110.0f + 20 * v) / audio::rate;
+        float *phase = &phases[v];
+        voices.push_back(new mix_t([phase, increment](float *out, int frames) {
+            float p = *phase;
+            for (int i = 0; i < frames; i++) {
+                p += increment;
+                if (p >= 1)
+                    p -= 1;
+                out[i] = (p - 0.5f) * 0.01f;
+            }
+            *phase = p;
+        }));
+        a->add(voices.back());
+
+        float *perSamplePhase = &perSamplePhases[v];
+        perSample.push_back([perSamplePhase, increment] {
+            *perSamplePhase += increment;
+            if (*perSamplePhase >= 1)
+                *perSamplePhase -= 1;
+            return (*perSamplePhase - 0.5f) * 0.01f;
+        });
+    }
+
+    float buffer[FRAMES * audio::channels];
+    volatile float sink = 0;
+    for (int c = 0; c < CALLBACKS / 10; c++)
+        a->process(buffer, FRAMES, audio::channels);
+
+    benchmark_clock::time_point start = benchmark_clock::now();
+    for (int c = 0; c < CALLBACKS; c++) {
+        a->process(buffer, FRAMES, audio::channels);
+        sink = buffer[0];
+    }
+    double const blockNanoseconds = nanosecondsSince(start) / CALLBACKS;
+
+    /* What getMix() did before: every voice's per-sample function called once per frame and summed into a scalar. */
+    start = benchmark_clock::now();
+    for (int c = 0; c < CALLBACKS; c++) {
+        for (int i = 0; i < FRAMES; i++) {
+            float master = 0;
+            for (MixFunction &voice : perSample)
+                master += voice();
+            for (int channel = 0; channel < audio::channels; channel++)
+                buffer[i * audio::channels + channel] = master;
+        }
+        sink = buffer[0];
+    }
+    double const sampleNanoseconds = nanosecondsSince(start) / CALLBACKS;
+
+    start = benchmark_clock::now();
+    for (int c = 0; c < CALLBACKS; c++) {
+        for (int i = 0; i < FRAMES; i++) {
+            float const master = a->getMix();
+            for (int channel = 0; channel < audio::channels; channel++)
+                buffer[i * audio::channels + channel] = master;
+        }
+        sink = buffer[0];
+    }
+    double const getMixNanoseconds = nanosecondsSince(start) / CALLBACKS;
+
+    std::printf("%d voices x %d frames per callback\n", VOICES, FRAMES);
+    std::printf("process():           %8.1f us/callback\n", blockNanoseconds / 1e3);
+    std::printf("per-sample, before:  %8.1f us/callback\n", sampleNanoseconds / 1e3);
+    std::printf("getMix() over blocks: %7.1f us/callback\n", getMixNanoseconds / 1e3);
+
+    for (mix_t *mix : voices)
+        a->remove(mix);
+    for (mix_t *mix : voices)
+        delete mix;
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * Renders audio offline against a fake clock: a render loop running at a jittery 60 fps
+ * cues a mix to start on every beat and stop half a beat later, while audio callbacks
+ * arrive a few milliseconds late. Each onset in the output is compared with the sample
+ * its beat maps to, and the test fails if any lands more than a sample away. Build
+ * against openFrameworks with the addon and its dependencies and run.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "audio.h"
+
+using namespace ofxBenG;
+
+static uint64_t now = 0;
+
+int main() {
+    audio *a = audio::getInstance();
+    a->setMicrosecondsSource([] { return now; });
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> callbackLateness(0, 3000);
+    std::uniform_real_distribution<double> frameMicroseconds(10000, 25000);
+
+    float const tempo = 120;
+    int const beats = 64;
+    float const firstBeat = 2;
+    double const callbackMicroseconds = audio::bufferSize * 1e6 / audio::rate;
+
+    mix_t *mix = new mix_t([] { return 1.0f; });
+    std::vector<float> output;
+    float buffer[audio::bufferSize];
+
+    double nextFrame = 0;
+    double nextCallback = callbackLateness(random);
+    uint64_t firstCallback = 0;
+    int cued = 0;
+    while (cued < beats || output.size() < (std::size_t) ((firstBeat + beats + 1) * 60 / tempo * audio::rate)) {
+        if (nextFrame < nextCallback) {
+            now = (uint64_t) nextFrame;
+            frame_clock clock;
+            clock.microseconds = now;
+            clock.tempo = tempo;
+            clock.beat = (float) (now * tempo / 60e6);
+            clock.phase = clock.beat - std::floor(clock.beat);
+            while (cued < beats && firstBeat + cued < clock.beat + 1) {
+                float const beat = firstBeat + cued;
+                a->cue(audio_cue::startMix(mix, beat, clock));
+                a->cue(audio_cue::stopMix(mix, beat + 0.5f, clock));
+                cued++;
+            }
+            nextFrame += frameMicroseconds(random);
+        } else {
+            now = (uint64_t) nextCallback;
+            if (output.empty())
+                firstCallback = now;
+            a->process(buffer, audio::bufferSize, 1);
+            output.insert(output.end(), buffer, buffer + audio::bufferSize);
+            nextCallback = output.size() / audio::bufferSize * callbackMicroseconds + callbackLateness(random);
+        }
+    }
+
+    std::vector<long> onsets;
+    for (std::size_t i = 1; i < output.size(); i++) {
+        if (output[i] != 0 && output[i - 1] == 0)
+            onsets.push_back((long) i);
+    }
+
+    int failures = 0;
+    long worst = 0;
+    if (onsets.size() != (std::size_t) beats) {
+        printf("expected %d onsets, found %zu\n", beats, onsets.size());
+        failures++;
+    }
+    for (std::size_t k = 0; k < onsets.size() && k < (std::size_t) beats; k++) {
+        double const target = (firstBeat + k) * 60e6 / tempo;
+        long const expected = (long) ((target - firstCallback) * audio::rate / 1e6) + audio::cueLatencySamples;
+        long const error = onsets[k] - expected;
+        worst = std::max(worst, std::abs(error));
+        if (std::abs(error) > 1) {
+            printf("onset %zu at sample %ld, expected %ld\n", k, onsets[k], expected);
+            failures++;
+        }
+    }
+
+    printf("%zu onsets, worst error %ld samples (%.3f ms)\n", onsets.size(), worst, worst * 1e3 / audio::rate);
+    a->retire(mix);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/*
+ * Feeds 600 synthetic 1080p RGBA frames, ten seconds at 60 fps, through two capture paths
+ * and reports pixel copies, texture uploads and CPU time per frame. The old path is what
+ * ofxPm::VideoBuffer and BlackMagicVideoSource did: every buffer recording the stream copies
+ * each frame into a VideoFrame of its own, and the frame is uploaded to a texture as soon as
+ * it arrives. The new path captures into one frame_history, as YUV 4:2:0, which the live
+ * window and two recording flicker windows share, and only the one frame_header that draws
+ * uploads it, as three planes its shader converts. It runs twice: converting to YUV on the
+ * render thread with capture(), and on the history's worker with queueCapture() and
+ * finishCapture(), as video_stream does.
+ * glFinish() closes every frame so upload time is included. Besides wall time per frame it
+ * reports the CPU time the render thread itself spent, which is what the worker takes off
+ * it; on a machine with a spare core the two agree. Needs openFrameworks and a GL
+ * driver; on a server, run it under a virtual display such as xvfb-run with Mesa.
+ */
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+#include "ofMain.h"
+#include "frame_history.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const WIDTH = 1920;
+static int const HEIGHT = 1080;
+static int const FRAMES = 600;
+static int const SOURCES = 4;
+static int const BUFFERS = 3;
+static int const RING = 8;
+static int const HISTORY = 30;
+
+/* A few distinct driver buffers to cycle through, so no copy is served from cache. */
+static std::vector<ofPixels> makeSources() {
+    std::vector<ofPixels> sources(SOURCES);
+    for (int s = 0; s < SOURCES; s++) {
+        sources[s].allocate(WIDTH, HEIGHT, OF_PIXELS_RGBA);
+        uint8_t* data = sources[s].getData();
+        for (std::size_t i = 0; i < sources[s].getTotalBytes(); i++) {
+            data[i] = (uint8_t) (i * 7 + s * 31 + (i >> 12));
+        }
+    }
+    return sources;
+}
+
+struct result {
+    double copies;
+    double uploads;
+    double microseconds;
+    double threadMicroseconds;
+};
+
+/* CPU time of the calling thread, so work moved to another thread drops out. */
+static double threadMicroseconds() {
+#ifndef _WIN32
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+#else
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <typename Frame>
+static double timeFrames(Frame frame, double &threadTime) {
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    double const threadStart = threadMicroseconds();
+    for (int i = 0; i < FRAMES; i++) {
+        frame(i);
+        glFinish();
+    }
+    threadTime = (threadMicroseconds() - threadStart) / FRAMES;
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count() / FRAMES;
+}
+
+/* Each buffer copies the frame into a ring of its own and the texture is loaded on arrival. */
+static result runOldPath(const std::vector<ofPixels>& sources) {
+    std::vector<std::vector<ofPixels>> buffers(BUFFERS, std::vector<ofPixels>(RING));
+    ofTexture texture;
+    long copies = 0;
+    long uploads = 0;
+    double threadTime = 0;
+    double const microseconds = timeFrames([&](int i) {
+        const ofPixels& incoming = sources[i % SOURCES];
+        for (auto& buffer : buffers) {
+            buffer[i % RING] = incoming;
+            copies++;
+        }
+        texture.loadData(buffers[0][i % RING]);
+        uploads++;
+        texture.draw(0, 0, WIDTH / 4, HEIGHT / 4);
+    }, threadTime);
+    return result{(double) copies / FRAMES, (double) uploads / FRAMES, microseconds, threadTime};
+}
+
+/* One capture into the shared history; only the drawn header uploads. */
+static result runNewPath(const std::vector<ofPixels>& sources, bool isQueued, bool& isShared, uint64_t& dropped) {
+    frame_history history(HISTORY);
+    frame_window live(history);
+    frame_window first(history), second(history);
+    first.resume();
+    second.resume();
+    frame_header shown;
+    shown.setup(live);
+
+    long uploads = 0;
+    uint64_t lastDrawn = 0;
+    uint64_t const capturesBefore = history.getPool().getCaptureCount();
+    double threadTime = 0;
+    double const microseconds = timeFrames([&](int i) {
+        uint64_t const timestamp = (uint64_t) i * 1000000 / 60;
+        if (isQueued) {
+            history.finishCapture();
+            history.queueCapture(sources[i % SOURCES], timestamp);
+        } else {
+            history.capture(sources[i % SOURCES], timestamp);
+        }
+        frame_ref next = shown.getNextFrame();
+        if (next && next->getSequence() != lastDrawn) {
+            lastDrawn = next->getSequence();
+            uploads++;
+        }
+        shown.draw(0, 0, WIDTH / 4, HEIGHT / 4);
+    }, threadTime);
+    history.finishCapture();
+    long const copies = (long) (history.getPool().getCaptureCount() - capturesBefore);
+    dropped = history.getPool().getDroppedCount();
+
+    uint64_t const newest = history.getPushedCount() - 1;
+    frame_ref fromLive = live.getFrame(newest);
+    isShared = fromLive && &*fromLive == &*first.getFrame(newest) && &*fromLive == &*second.getFrame(newest);
+    return result{(double) copies / FRAMES, (double) uploads / FRAMES, microseconds, threadTime};
+}
+
+int main() {
+    ofGLFWWindowSettings settings;
+    settings.setGLVersion(3, 2);
+    settings.visible = false;
+    settings.width = WIDTH / 4;
+    settings.height = HEIGHT / 4;
+    ofCreateWindow(settings);
+
+    std::vector<ofPixels> const sources = makeSources();
+    result const before = runOldPath(sources);
+    bool isShared = false;
+    bool isQueuedShared = false;
+    uint64_t dropped = 0;
+    uint64_t queuedDropped = 0;
+    result const after = runNewPath(sources, false, isShared, dropped);
+    result const queued = runNewPath(sources, true, isQueuedShared, queuedDropped);
+
+    std::printf("%d frames of %dx%d RGBA, %d buffers or windows recording, 1 drawn\n", FRAMES, WIDTH, HEIGHT, BUFFERS);
+    std::printf("%-26s %14s %14s %12s %18s\n", "", "copies/frame", "uploads/frame", "us/frame", "render CPU us/frame");
+    std::printf("%-26s %14.2f %14.2f %12.1f %18.1f\n", "VideoBuffer per buffer", before.copies, before.uploads, before.microseconds, before.threadMicroseconds);
+    std::printf("%-26s %14.2f %14.2f %12.1f %18.1f\n", "frame_history, capture()", after.copies, after.uploads, after.microseconds, after.threadMicroseconds);
+    std::printf("%-26s %14.2f %14.2f %12.1f %18.1f\n", "frame_history, worker", queued.copies, queued.uploads, queued.microseconds, queued.threadMicroseconds);
+    std::printf("frame budget at 60 fps: %.1f us, dropped captures: %llu\n", 1000000.0 / 60, (unsigned long long) (dropped + queuedDropped));
+    std::printf("windows share one copy: %s\n", isShared && isQueuedShared ? "yes" : "no");
+    return (isShared && isQueuedShared && dropped + queuedDropped == 0) ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/*
+ * Memory held by four overlapping flickers on one 1080p stream. The stream keeps a
+ * 300-frame history; the flickers record 120 frames each, starting 30 frames apart. Before,
+ * the stream's default buffer and every flicker's VideoBuffer each kept their own RGBA copy
+ * of every frame, so that figure is worked out from the buffer sizes. After, the history and
+ * the flicker windows share pooled frames, so the program captures the frames and counts
+ * the distinct ones still referenced: once while the recordings are inside the ring and
+ * again after the ring has moved past all of them. Pool slots only get pixels when first
+ * filled, so the reserved count is a bound, not an allocation. It also checks that every
+ * stopped recording still has all its frames. Build against openFrameworks with the addon
+ * and its dependencies and run.
+ */
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <vector>
+#include "ofMain.h"
+#include "frame_history.h"
+
+using namespace ofxBenG;
+
+static int const WIDTH = 1920;
+static int const HEIGHT = 1080;
+static int const HISTORY = 300;
+static int const FLICKERS = 4;
+static int const RECORDING = 120;
+static int const STAGGER = 30;
+
+static double const MEGABYTE = 1024.0 * 1024.0;
+
+struct usage {
+    std::size_t frames;
+    double megabytes;
+};
+
+/* Distinct pooled frames reachable from the history or any recording, and their pixel bytes. */
+static usage measure(const frame_history& history, const std::vector<std::unique_ptr<frame_window>>& recordings) {
+    std::set<const video_frame*> held;
+    double bytes = 0;
+    auto count = [&](const frame_ref& frame) {
+        if (frame && held.insert(&*frame).second) {
+            bytes += frame->getPixels().getTotalBytes();
+        }
+    };
+    for (uint64_t i = history.getPushedCount() - history.size(); i < history.getPushedCount(); i++) {
+        count(history.getFrame(i));
+    }
+    for (const auto& recording : recordings) {
+        for (uint64_t i = recording->getStart(); i < recording->getStart() + recording->size(); i++) {
+            count(recording->getFrame(i));
+        }
+    }
+    return usage{held.size(), bytes / MEGABYTE};
+}
+
+static bool isComplete(const frame_window& recording) {
+    if (recording.size() != (std::size_t) RECORDING)
+        return false;
+    for (uint64_t i = recording.getStart(); i < recording.getStart() + recording.size(); i++) {
+        if (!recording.getFrame(i))
+            return false;
+    }
+    return true;
+}
+
+int main() {
+    ofPixels source;
+    source.allocate(WIDTH, HEIGHT, OF_PIXELS_RGBA);
+    std::size_t const rgbaBytes = source.getTotalBytes();
+
+    frame_history history(HISTORY);
+    std::vector<std::unique_ptr<frame_window>> recordings;
+    for (int f = 0; f < FLICKERS; f++) {
+        recordings.emplace_back(new frame_window(history));
+    }
+
+    int const wrapped = (FLICKERS - 1) * STAGGER + RECORDING + HISTORY;
+    usage inside = {0, 0};
+    for (int frame = 0; frame <= wrapped; frame++) {
+        for (int f = 0; f < FLICKERS; f++) {
+            if (frame == f * STAGGER) {
+                recordings[f]->resume();
+            } else if (frame == f * STAGGER + RECORDING) {
+                recordings[f]->stop();
+            }
+        }
+        if (frame == HISTORY) {
+            inside = measure(history, recordings);
+        }
+        if (frame < wrapped) {
+            history.capture(source, (uint64_t) frame * 1000000 / 60);
+        }
+    }
+    usage const after = measure(history, recordings);
+
+    std::size_t const copies = HISTORY + FLICKERS * RECORDING;
+    std::printf("%d flickers of %d frames, %d apart, on a %d-frame history of %dx%d RGBA\n", FLICKERS, RECORDING, STAGGER, HISTORY, WIDTH, HEIGHT);
+    std::printf("%-40s %8s %10s\n", "", "frames", "MB");
+    std::printf("%-40s %8zu %10.0f\n", "VideoBuffer per flicker, RGBA", copies, copies * rgbaBytes / MEGABYTE);
+    std::printf("%-40s %8zu %10.0f\n", "shared history, recordings in the ring", inside.frames, inside.megabytes);
+    std::printf("%-40s %8zu %10.0f\n", "shared history, ring past recordings", after.frames, after.megabytes);
+    std::printf("pool slots reserved: %zu, dropped captures: %llu\n", history.getPool().getCapacity(),
+                (unsigned long long) history.getPool().getDroppedCount());
+
+    int failures = 0;
+    for (int f = 0; f < FLICKERS; f++) {
+        if (!isComplete(*recordings[f])) {
+            std::printf("FAIL: recording %d lost frames\n", f);
+            failures++;
+        }
+    }
+    if (history.getPool().getDroppedCount() != 0) {
+        std::printf("FAIL: captures were dropped\n");
+        failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/*
+ * Round trips frame_codec over flat, patterned, noisy and tiny inputs, and checks that
+ * decompress() refuses truncated and corrupted blocks instead of overrunning. Needs only
+ * the addon's src on the include path; exits non-zero on failure.
+ */
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "frame_codec.h"
+
+using namespace ofxBenG;
+
+static int failures = 0;
+
+static void check(bool condition, const char *what, std::size_t size) {
+    if (!condition) {
+        std::printf("FAILED: %s (size %zu)\n", what, size);
+        failures++;
+    }
+}
+
+static void roundTrip(const std::vector<uint8_t> &source, std::mt19937 &random) {
+    std::size_t const size = source.size();
+    std::vector<uint8_t> compressed(frame_codec::getBound(size));
+    std::size_t const compressedSize = frame_codec::compress(source.data(), size, compressed.data(), compressed.size());
+    check(compressedSize <= compressed.size(), "compressed size within bound", size);
+
+    std::vector<uint8_t> restored(size);
+    check(frame_codec::decompress(compressed.data(), compressedSize, restored.data(), size), "decompress", size);
+    check(restored == source, "round trip", size);
+
+    std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + compressedSize - 1);
+    check(!frame_codec::decompress(truncated.data(), truncated.size(), restored.data(), size), "reject truncated", size);
+
+    /* Corruption may still decode to something; it only has to stay in bounds, which the sanitizers check. */
+    for (int i = 0; i < 16; i++) {
+        std::vector<uint8_t> corrupted(compressed.begin(), compressed.begin() + compressedSize);
+        corrupted[random() % compressedSize] = (uint8_t) random();
+        frame_codec::decompress(corrupted.data(), corrupted.size(), restored.data(), size);
+    }
+}
+
+int main() {
+    std::mt19937 random(1);
+    for (std::size_t size = 1; size < 300; size++) {
+        std::vector<uint8_t> noise(size);
+        for (auto &byte : noise) {
+            byte = (uint8_t) random();
+        }
+        roundTrip(noise, random);
+        roundTrip(std::vector<uint8_t>(size, 7), random);
+    }
+
+    std::size_t const width = 640, height = 480;
+    std::vector<uint8_t> flat(width * height, 16);
+    std::vector<uint8_t> pattern(width * height);
+    std::vector<uint8_t> sensor(width * height);
+    for (std::size_t y = 0; y < height; y++) {
+        for (std::size_t x = 0; x < width; x++) {
+            pattern[y * width + x] = (uint8_t) (16 + (x / 8 + y / 8) % 200);
+            sensor[y * width + x] = (uint8_t) (pattern[y * width + x] + random() % 4);
+        }
+    }
+    roundTrip(flat, random);
+    roundTrip(pattern, random);
+    roundTrip(sensor, random);
+
+    std::printf("frame_codec: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+/*
+ * Draws captured I420 frames through frame_header, whose fragment shader converts the Y, U
+ * and V planes on the GPU, and compares what lands in a framebuffer with yuv420::toRgb on
+ * the same frames: shown alone, held through getTexture(), and blended half way between two
+ * frames. The GPU filters chroma bilinearly where toRgb repeats it, so smooth frames differ
+ * by a few levels at most. Frames are mirror images top to bottom, which keeps the check
+ * independent of which way up the framebuffer stores rows. Needs openFrameworks and a GL
+ * driver; on a server, run it under a virtual display such as xvfb-run with Mesa. Exits
+ * non-zero on failure.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "ofMain.h"
+#include "frame_history.h"
+
+using namespace ofxBenG;
+
+static int const WIDTH = 64;
+static int const HEIGHT = 32;
+static int const MAX_ERROR = 8;
+
+static ofPixels makeFrame(int shift) {
+    ofPixels pixels;
+    pixels.allocate(WIDTH, HEIGHT, OF_PIXELS_RGBA);
+    for (int y = 0; y < HEIGHT; y++) {
+        int const row = std::min(y, HEIGHT - 1 - y);
+        for (int x = 0; x < WIDTH; x++) {
+            uint8_t *pixel = pixels.getData() + (y * WIDTH + x) * 4;
+            pixel[0] = (uint8_t) (40 + 2 * x + shift);
+            pixel[1] = (uint8_t) (200 - 6 * row);
+            pixel[2] = (uint8_t) (60 + x + row + shift / 2);
+            pixel[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+static int worstError(const ofPixels &drawn, const ofPixels &expected) {
+    int worst = 0;
+    std::size_t const channels = drawn.getNumChannels();
+    for (std::size_t i = 0; i < (std::size_t) WIDTH * HEIGHT; i++) {
+        for (std::size_t c = 0; c < 3; c++) {
+            worst = std::max(worst, std::abs(drawn.getData()[i * channels + c] - expected.getData()[i * 3 + c]));
+        }
+    }
+    return worst;
+}
+
+static ofPixels drawToPixels(frame_header &header, ofFbo &fbo) {
+    fbo.begin();
+    ofClear(0);
+    ofSetColor(255);
+    header.draw(0, 0, WIDTH, HEIGHT);
+    fbo.end();
+    ofPixels pixels;
+    fbo.readToPixels(pixels);
+    return pixels;
+}
+
+int main() {
+    ofGLFWWindowSettings settings;
+    settings.setGLVersion(3, 2);
+    settings.visible = false;
+    ofCreateWindow(settings);
+
+    frame_history history(4);
+    frame_window window(history);
+    history.capture(makeFrame(0), 0);
+    history.capture(makeFrame(60), 1);
+    ofPixels first, second;
+    yuv420::toRgb(window.getFrame(0)->getPixels(), first);
+    yuv420::toRgb(window.getFrame(1)->getPixels(), second);
+    ofPixels halfway = first;
+    for (std::size_t i = 0; i < halfway.getTotalBytes(); i++) {
+        halfway.getData()[i] = (uint8_t) ((first.getData()[i] + second.getData()[i] + 1) / 2);
+    }
+
+    ofFbo fbo;
+    fbo.allocate(WIDTH, HEIGHT, GL_RGBA);
+    frame_header header;
+    header.setup(window);
+    int failures = 0;
+
+    header.setFramePosition(0);
+    int const shown = worstError(drawToPixels(header, fbo), first);
+    ofPixels held;
+    header.getTexture().readToPixels(held);
+    int const fromTexture = worstError(held, first);
+    header.setBlending(true);
+    header.setFramePosition(0.5);
+    int const blended = worstError(drawToPixels(header, fbo), halfway);
+
+    std::printf("%-12s %12s\n", "", "worst error");
+    std::printf("%-12s %12d\n", "shown", shown);
+    std::printf("%-12s %12d\n", "getTexture", fromTexture);
+    std::printf("%-12s %12d\n", "blended", blended);
+    failures += shown > MAX_ERROR;
+    failures += fromTexture > MAX_ERROR;
+    failures += blended > MAX_ERROR;
+    if (failures > 0) {
+        std::printf("%d failures, allowed %d levels\n", failures, MAX_ERROR);
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * Sustained 1080p60 recording into a frame_history with a disk spill behind a 2-second RAM
+ * ring, while a header shows the stream 5 seconds late, so every frame it shows comes back
+ * off disk. Frames arrive on a 60 fps clock for 20 seconds. Each tick captures a frame and
+ * asks the header for its frame, as the render loop would. The program times that work
+ * against the frame budget and counts two things: frames the spill dropped because the
+ * disk fell behind, and shown frames the read-ahead had not decoded in time, where the
+ * header would hold the last one instead. The frames are camera-like: a moving gradient
+ * under a little sensor noise. It fails if the header gets the wrong frame back or nothing
+ * is ever read from disk. Build against openFrameworks with the addon and its dependencies
+ * and run; it needs about 2 GB of free disk where it runs.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "ofMain.h"
+#include "frame_history.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const WIDTH = 1920;
+static int const HEIGHT = 1080;
+static int const FPS = 60;
+static int const RAM_FRAMES = 2 * FPS;
+static int const SPILL_FRAMES = 10 * FPS;
+static int const DELAY_FRAMES = 5 * FPS;
+static int const READ_AHEAD = 8;
+static int const FRAMES = 20 * FPS;
+static int const SOURCES = 8;
+
+static std::vector<ofPixels> makeSources() {
+    std::vector<ofPixels> sources(SOURCES);
+    uint32_t noise = 12345;
+    for (int s = 0; s < SOURCES; s++) {
+        sources[s].allocate(WIDTH, HEIGHT, OF_PIXELS_RGBA);
+        uint8_t* pixel = sources[s].getData();
+        for (int y = 0; y < HEIGHT; y++) {
+            for (int x = 0; x < WIDTH; x++) {
+                noise = noise * 1664525 + 1013904223;
+                int const grain = (int) (noise >> 30) - 2;
+                bool const isBar = ((x + s * 40) / 120) % 8 == 0;
+                int const base = isBar ? 230 : (x / 8 + y / 6 + s * 3) % 200;
+                pixel[0] = (uint8_t) std::min(std::max(base + grain, 0), 255);
+                pixel[1] = (uint8_t) std::min(std::max(base / 2 + 40 + grain, 0), 255);
+                pixel[2] = (uint8_t) std::min(std::max(180 - base / 3 + grain, 0), 255);
+                pixel[3] = 255;
+                pixel += 4;
+            }
+        }
+    }
+    return sources;
+}
+
+int main() {
+    std::vector<ofPixels> const sources = makeSources();
+
+    frame_history history(RAM_FRAMES);
+    if (!history.setSpill("frame_spill_benchmark.spill", SPILL_FRAMES, READ_AHEAD)) {
+        std::printf("FAIL: could not create the spill file\n");
+        return 1;
+    }
+    frame_window live(history);
+    frame_header delayed;
+    delayed.setup(live);
+    delayed.setDelayFrames(DELAY_FRAMES);
+
+    std::vector<double> work;
+    int late = 0;
+    int diskReads = 0;
+    int misses = 0;
+    int wrongFrames = 0;
+    std::chrono::microseconds const period(1000000 / FPS);
+    benchmark_clock::time_point deadline = benchmark_clock::now();
+    for (int i = 0; i < FRAMES; i++) {
+        benchmark_clock::time_point const start = benchmark_clock::now();
+        history.capture(sources[i % SOURCES], (uint64_t) i * 1000000 / FPS);
+        frame_ref shown = delayed.getNextFrame();
+        work.push_back(std::chrono::duration<double, std::milli>(benchmark_clock::now() - start).count());
+
+        if (i >= DELAY_FRAMES) {
+            uint64_t const expected = history.getPushedCount() - 1 - DELAY_FRAMES;
+            if (expected < history.getMemoryStart()) {
+                diskReads++;
+                if (!shown) {
+                    misses++;
+                } else if (shown->getSequence() != expected + 1 || shown->getTimestamp() != expected * 1000000 / FPS) {
+                    wrongFrames++;
+                }
+            }
+        }
+
+        deadline += period;
+        if (benchmark_clock::now() > deadline) {
+            late++;
+            deadline = benchmark_clock::now();
+        }
+        std::this_thread::sleep_until(deadline);
+    }
+
+    std::sort(work.begin(), work.end());
+    double mean = 0;
+    for (double w : work) {
+        mean += w;
+    }
+    mean /= work.size();
+
+    std::printf("%d frames of %dx%d RGBA at %d fps: %d in RAM, %d on disk, shown %d behind\n", FRAMES, WIDTH, HEIGHT, FPS,
+                RAM_FRAMES, SPILL_FRAMES, DELAY_FRAMES);
+    std::printf("capture + read per frame: mean %.2f ms, p99 %.2f ms, worst %.2f ms of %.2f ms\n", mean,
+                work[work.size() * 99 / 100], work.back(), 1000.0 / FPS);
+    std::printf("ticks that overran the frame: %d\n", late);
+    std::printf("frames dropped by the spill: %llu, by the pool: %llu\n", (unsigned long long) history.getSpillDroppedCount(),
+                (unsigned long long) history.getPool().getDroppedCount());
+    std::printf("frames shown from disk: %d, not decoded in time: %d, wrong frame: %d\n", diskReads, misses, wrongFrames);
+
+    bool const isRead = diskReads > misses;
+    if (!isRead) {
+        std::printf("FAIL: no frame came back from disk\n");
+    }
+    if (wrongFrames != 0) {
+        std::printf("FAIL: the header got frames other than the ones it asked for\n");
+    }
+    return (isRead && wrongFrames == 0) ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+/*
+ * Colors 10,000 tracer strokes per frame with Hue, Saturation, Brightness, InvertHue and
+ * PerlinBrightness three ways: the separate stages chained per tracer, which round-trip
+ * through ofColor after each one, hsb_color_stage drawn per tracer, and hsb_color_stage's
+ * batch draw. Reports the time per frame and millions of colors per second. Build against
+ * openFrameworks with the addon and its dependencies and run.
+ */
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "hsb_color_stage.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const TRACERS = 10000;
+static int const FRAMES = 100;
+
+template <typename Draw>
+static double timeFrames(Draw draw) {
+    draw(0.0f);
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    for (int frame = 1; frame <= FRAMES; frame++) {
+        draw((float) frame);
+    }
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count() / FRAMES;
+}
+
+static void report(const char* label, double microseconds) {
+    std::printf("%-22s %12.1f %14.1f\n", label, microseconds, TRACERS / microseconds);
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+    property<int> hue("hue", 128, 0, 255);
+    property<int> saturation("saturation", 200, 0, 255);
+    property<int> brightness("brightness", 220, 0, 255);
+
+    std::vector<std::unique_ptr<Tracer>> tracers;
+    std::vector<Tracer*> batch;
+    std::vector<std::unique_ptr<StrokeColor>> strokes;
+    std::vector<std::unique_ptr<TracerDrawStrategy>> chains;
+    std::vector<std::unique_ptr<hsb_color_stage>> fused;
+    std::vector<hsb_color_stage*> stages;
+    for (int i = 0; i < TRACERS; i++) {
+        tracers.emplace_back(new Tracer(ofVec3f::zero(), ofVec3f::zero()));
+        batch.push_back(tracers.back().get());
+        strokes.emplace_back(new StrokeColor(ofColor(i % 256, (i * 7) % 256, (i * 13) % 256)));
+        StrokeColor* stroke = strokes.back().get();
+        ofVec3f const timeShift(i * 0.1f, 0, 0);
+        ofVec3f const velocity(0.01f, 0, 0);
+
+        Tracer* t = tracers.back().get();
+        chains.emplace_back(new Hue(stroke, hue));
+        t->addDrawBehavior(chains.back().get());
+        chains.emplace_back(new Saturation(stroke, saturation));
+        t->addDrawBehavior(chains.back().get());
+        chains.emplace_back(new Brightness(stroke, brightness));
+        t->addDrawBehavior(chains.back().get());
+        chains.emplace_back(new InvertHue(stroke));
+        t->addDrawBehavior(chains.back().get());
+        t->addDrawBehavior(stroke);
+        chains.emplace_back(new PerlinBrightness(timeShift, velocity));
+        t->addDrawBehavior(chains.back().get());
+
+        fused.emplace_back(new hsb_color_stage(stroke));
+        fused.back()->setHue(hue).setSaturation(saturation).setBrightness(brightness).setInvertHue(true).setPerlinBrightness(timeShift, velocity);
+        stages.push_back(fused.back().get());
+    }
+
+    double const chainedMicroseconds = timeFrames([&](float time) {
+        for (auto& t : tracers) {
+            t->draw(time, nullptr);
+        }
+    });
+    double const fusedMicroseconds = timeFrames([&](float time) {
+        for (int i = 0; i < TRACERS; i++) {
+            fused[i]->draw(batch[i], time, nullptr);
+        }
+    });
+    double const batchedMicroseconds = timeFrames([&](float time) {
+        hsb_color_stage::draw(stages, batch, time);
+    });
+
+    std::printf("%d strokes, 5 color stages\n", TRACERS);
+    std::printf("%-22s %12s %14s\n", "", "us per frame", "Mcolors per s");
+    report("chained stages", chainedMicroseconds);
+    report("fused per tracer", fusedMicroseconds);
+    report("fused batch", batchedMicroseconds);
+    return 0;
+}
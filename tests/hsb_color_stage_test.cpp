@@ -0,0 +1,205 @@
+/*
+ * Colors random strokes with the separate StrokeColor, Hue, Saturation, Brightness,
+ * InvertHue and PerlinBrightness stages and with one hsb_color_stage set up the same way,
+ * including black and grey strokes and every combination of stages. The chained stages round
+ * to 8-bit channels after each adjustment and the fused stage converts once, so with one
+ * adjustment the two must match exactly, with two they may differ by one color step, and
+ * each further adjustment may add one more step. A chain that passes through a color more
+ * than LOSSY_STEPS darker or less saturated than it ends with has lost hue precision on the
+ * way, which the fused stage keeps; those cases are only reported. The batch draw must match the single
+ * draw exactly. Build against openFrameworks with the addon and its dependencies and run.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "hsb_color_stage.h"
+
+using namespace ofxBenG;
+
+static int const CASES = 20000;
+static int const BATCH = 64;
+static int const LOSSY_STEPS = 8;
+
+struct color_case {
+    ofColor stroke;
+    int hue, saturation, brightness;
+    int stages;
+    ofVec3f timeShift;
+    ofVec3f velocity;
+    float time;
+};
+
+enum {
+    HUE = 1,
+    SATURATION = 2,
+    BRIGHTNESS = 4,
+    INVERT_HUE = 8,
+    PERLIN_BRIGHTNESS = 16
+};
+
+static color_case makeCase(std::mt19937& random) {
+    std::uniform_int_distribution<int> channel(0, 255);
+    std::uniform_real_distribution<float> unit(0, 1);
+    color_case c;
+    int const gray = channel(random);
+    switch (random() % 4) {
+        case 0:
+            c.stroke = ofColor(0, 0, 0);
+            break;
+        case 1:
+            c.stroke = ofColor(gray, gray, gray);
+            break;
+        default:
+            c.stroke = ofColor(channel(random), channel(random), channel(random), channel(random));
+            break;
+    }
+    c.hue = channel(random);
+    c.saturation = random() % 8 == 0 ? 0 : channel(random);
+    c.brightness = random() % 8 == 0 ? 0 : channel(random);
+    c.stages = random() % 32;
+    c.timeShift = ofVec3f(unit(random) * 100, 0, 0);
+    c.velocity = ofVec3f(unit(random), 0, 0);
+    c.time = unit(random) * 1000;
+    return c;
+}
+
+/* The inputs a case's stages mirror, kept alive as long as the stages that follow them. */
+struct sources {
+    property<int> hue = {"hue", 0, 0, 255};
+    property<int> saturation = {"saturation", 0, 0, 255};
+    property<int> brightness = {"brightness", 0, 0, 255};
+
+    explicit sources(const color_case& c) {
+        hue.set(c.hue);
+        saturation.set(c.saturation);
+        brightness.set(c.brightness);
+        hue.clean();
+        saturation.clean();
+        brightness.clean();
+    }
+};
+
+static void trackHsb(const ofColor& color, float& lowestS, float& lowestB) {
+    float h, s, b;
+    color.getHsb(h, s, b);
+    lowestS = std::min(lowestS, s);
+    lowestB = std::min(lowestB, b);
+}
+
+/* The separate stages' color; isLossy is set when an intermediate color was much darker or less saturated than the result. */
+static ofColor chained(const color_case& c, bool& isLossy) {
+    sources in(c);
+    StrokeColor stroke(c.stroke);
+    std::vector<std::unique_ptr<TracerDrawStrategy>> stages;
+    if (c.stages & HUE)
+        stages.emplace_back(new Hue(&stroke, in.hue));
+    if (c.stages & SATURATION)
+        stages.emplace_back(new Saturation(&stroke, in.saturation));
+    if (c.stages & BRIGHTNESS)
+        stages.emplace_back(new Brightness(&stroke, in.brightness));
+    if (c.stages & INVERT_HUE)
+        stages.emplace_back(new InvertHue(&stroke));
+    Tracer t(ofVec3f::zero(), ofVec3f::zero());
+    float lowestS = ofColor::limit();
+    float lowestB = ofColor::limit();
+    trackHsb(stroke.getColor(), lowestS, lowestB);
+    for (auto& stage : stages) {
+        stage->draw(&t, c.time, nullptr);
+        trackHsb(stroke.getColor(), lowestS, lowestB);
+    }
+    stroke.draw(&t, c.time, nullptr);
+    if (c.stages & PERLIN_BRIGHTNESS) {
+        PerlinBrightness perlin(c.timeShift, c.velocity);
+        perlin.draw(&t, c.time, nullptr);
+    }
+    ofColor const result = t.path.getStrokeColor();
+    float h, s, b;
+    result.getHsb(h, s, b);
+    isLossy = s > lowestS + LOSSY_STEPS || b > lowestB + LOSSY_STEPS;
+    return result;
+}
+
+static int countAdjustments(int stages) {
+    int count = 0;
+    for (int stage = HUE; stage <= PERLIN_BRIGHTNESS; stage <<= 1) {
+        if (stages & stage)
+            count++;
+    }
+    return count;
+}
+
+struct fused_case {
+    explicit fused_case(const color_case& c) : in(c), stroke(c.stroke), stage(&stroke), t(ofVec3f::zero(), ofVec3f::zero()) {
+        if (c.stages & HUE)
+            stage.setHue(in.hue);
+        if (c.stages & SATURATION)
+            stage.setSaturation(in.saturation);
+        if (c.stages & BRIGHTNESS)
+            stage.setBrightness(in.brightness);
+        stage.setInvertHue((c.stages & INVERT_HUE) != 0);
+        if (c.stages & PERLIN_BRIGHTNESS)
+            stage.setPerlinBrightness(c.timeShift, c.velocity);
+    }
+
+    sources in;
+    StrokeColor stroke;
+    hsb_color_stage stage;
+    Tracer t;
+};
+
+static int channelError(const ofColor& a, const ofColor& b) {
+    return std::max(std::max(std::abs(a.r - b.r), std::abs(a.g - b.g)), std::max(std::abs(a.b - b.b), std::abs(a.a - b.a)));
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+    std::mt19937 random(13);
+    int failures = 0;
+    int worstLossy = 0;
+    int lossy = 0;
+    int offByOne = 0;
+    int batchMismatches = 0;
+    for (int first = 0; first < CASES; first += BATCH) {
+        std::vector<color_case> cases;
+        std::vector<std::unique_ptr<fused_case>> fused;
+        std::vector<hsb_color_stage*> stages;
+        std::vector<Tracer*> tracers;
+        for (int i = 0; i < BATCH; i++) {
+            cases.push_back(makeCase(random));
+            fused.emplace_back(new fused_case(cases.back()));
+            stages.push_back(&fused.back()->stage);
+            tracers.push_back(&fused.back()->t);
+        }
+        hsb_color_stage::draw(stages, tracers, cases.front().time);
+
+        for (int i = 0; i < BATCH; i++) {
+            color_case c = cases[i];
+            c.time = cases.front().time;
+            ofColor const batched = fused[i]->t.path.getStrokeColor();
+            fused[i]->stage.draw(&fused[i]->t, c.time, nullptr);
+            ofColor const single = fused[i]->t.path.getStrokeColor();
+            if (channelError(single, batched) != 0)
+                batchMismatches++;
+
+            bool isLossy;
+            int const error = channelError(single, chained(c, isLossy));
+            int const adjustments = countAdjustments(c.stages);
+            int const tolerance = adjustments <= 1 ? 0 : adjustments - 1;
+            if (isLossy) {
+                lossy++;
+                worstLossy = std::max(worstLossy, error);
+            } else if (error > tolerance) {
+                failures++;
+                std::printf("case %d: stroke (%d, %d, %d) hue %d saturation %d brightness %d stages %d differs by %d\n",
+                            first + i, c.stroke.r, c.stroke.g, c.stroke.b, c.hue, c.saturation, c.brightness, c.stages, error);
+            } else if (error == 1) {
+                offByOne++;
+            }
+        }
+    }
+    std::printf("%d cases: %d outside tolerance, %d off by one, %d batch mismatches\n", CASES, failures, offByOne, batchMismatches);
+    std::printf("%d chains lost precision on the way; the fused stage differs from them by up to %d\n", lossy, worstLossy);
+    return failures == 0 && batchMismatches == 0 ? 0 : 1;
+}
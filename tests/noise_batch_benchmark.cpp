@@ -0,0 +1,67 @@
+/*
+ * Looks up 10,000 noise values per frame, the count a large tracer scene asks for, once
+ * through ofNoise(float) one call at a time, as reproduced in noise_batch_reference.h, and
+ * once through a reused noise_batch. Reports the time per frame and millions of lookups per
+ * second, and checks that both give the same values.
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "noise_batch.h"
+#include "noise_batch_reference.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const LOOKUPS = 10000;
+static int const FRAMES = 1000;
+
+template <typename Frame>
+static double timeFrames(Frame frame) {
+    frame(0.0f);
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    for (int i = 1; i <= FRAMES; i++) {
+        frame((float) i);
+    }
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count() / FRAMES;
+}
+
+static void report(const char *label, double microseconds) {
+    std::printf("%-16s %12.1f %14.1f\n", label, microseconds, LOOKUPS / microseconds);
+}
+
+static float inputOf(int i, float time) {
+    return time * 0.01f + i * 0.37f;
+}
+
+int main() {
+    std::vector<float> scalar(LOOKUPS);
+    double const scalarMicroseconds = timeFrames([&](float time) {
+        for (int i = 0; i < LOOKUPS; i++) {
+            scalar[i] = reference::ofNoise(inputOf(i, time));
+        }
+    });
+
+    noise_batch batch;
+    double const batchedMicroseconds = timeFrames([&](float time) {
+        batch.clear();
+        for (int i = 0; i < LOOKUPS; i++) {
+            batch.add(inputOf(i, time));
+        }
+        batch.evaluate();
+    });
+
+    bool isSame = true;
+    for (int i = 0; i < LOOKUPS; i++) {
+        if (batch[i] != scalar[i])
+            isSame = false;
+    }
+
+    std::printf("%d lookups per frame\n", LOOKUPS);
+    std::printf("%-16s %12s %14s\n", "", "us per frame", "Mlookups per s");
+    report("ofNoise", scalarMicroseconds);
+    report("noise_batch", batchedMicroseconds);
+    std::printf("same values: %s\n", isSame ? "yes" : "no");
+    return isSame ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+/*
+ * Compares noise_batch bit for bit with openFrameworks' ofNoise(float), reproduced in
+ * noise_batch_reference.h: a dense sweep across integer boundaries, random inputs of every
+ * magnitude, negative integers, signed zeros, batches of odd sizes, and a batch reused after
+ * clear(). Needs only the addon's src on the include path; exits non-zero on failure.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "noise_batch.h"
+#include "noise_batch_reference.h"
+
+using namespace ofxBenG;
+
+static int failures = 0;
+
+static bool isSameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static void check(float x, float actual, const char *what) {
+    float const expected = reference::ofNoise(x);
+    if (!isSameBits(actual, expected)) {
+        if (failures < 20)
+            std::printf("FAILED: %s at %.9g: %.9g, ofNoise gives %.9g\n", what, x, actual, expected);
+        failures++;
+    }
+}
+
+static void checkBatch(noise_batch &batch, const std::vector<float> &inputs, const char *what) {
+    batch.clear();
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        if (batch.add(inputs[i]) != i) {
+            std::printf("FAILED: %s: add() returned the wrong index\n", what);
+            failures++;
+        }
+    }
+    batch.evaluate();
+    if (batch.size() != inputs.size()) {
+        std::printf("FAILED: %s: size %zu, expected %zu\n", what, batch.size(), inputs.size());
+        failures++;
+        return;
+    }
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        check(inputs[i], batch[i], what);
+        check(inputs[i], noise_batch::noise(inputs[i]), what);
+    }
+}
+
+int main() {
+    noise_batch batch;
+    std::vector<float> inputs;
+
+    for (int i = -300 * 64; i <= 300 * 64; i++) {
+        inputs.push_back(i / 64.0f);
+    }
+    checkBatch(batch, inputs, "sweep");
+
+    inputs.clear();
+    for (int i = -1000; i <= 1000; i++) {
+        inputs.push_back((float) i);
+        inputs.push_back(std::nextafter((float) i, -2000.0f));
+        inputs.push_back(std::nextafter((float) i, 2000.0f));
+    }
+    inputs.push_back(0.0f);
+    inputs.push_back(-0.0f);
+    checkBatch(batch, inputs, "integers and their neighbours");
+
+    std::mt19937 random(14);
+    std::uniform_real_distribution<float> unit(-1, 1);
+    inputs.clear();
+    for (int i = 0; i < 100000; i++) {
+        float const magnitude = std::pow(10.0f, (float) (i % 8) - 3);
+        inputs.push_back(unit(random) * magnitude);
+    }
+    checkBatch(batch, inputs, "random");
+
+    /* Odd sizes exercise whatever remainder handling the compiler's vectorized loop has. */
+    for (std::size_t size = 1; size <= 67; size += 2) {
+        std::vector<float> odd(inputs.begin(), inputs.begin() + size);
+        checkBatch(batch, odd, "odd batch");
+    }
+
+    std::printf("noise_batch: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
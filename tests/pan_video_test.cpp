@@ -0,0 +1,66 @@
+/*
+ * Drives pan_video::getFramePosition() from a fake clock whose frame intervals jitter,
+ * and checks that the position never moves against the sweep, stays within a small error
+ * of the ideal one, and lands exactly on the last frame once the sweep is over. Build
+ * against openFrameworks with the addon and its dependencies, like any file in src/, and
+ * run; exits non-zero on failure.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "beat_action.h"
+
+using namespace ofxBenG;
+
+int main() {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> jitter(0.5, 1.8);
+    int failures = 0;
+
+    for (int trial = 0; trial < 200; trial++) {
+        double const bpm = 60 + random() % 120;
+        float const startBeat = 1000 + (random() % 10000) / 7.0f;
+        float const lengthBeats = 1 + random() % 16;
+        std::size_t const frameCount = 1 + random() % 900;
+        bool const playForwards = trial % 2 == 0;
+        double const frameSeconds = 1.0 / (24 + random() % 120);
+        double const last = frameCount - 1;
+
+        double seconds = 0;
+        double previous = playForwards ? 0 : last;
+        double worstError = 0;
+        while (true) {
+            float const beat = startBeat + (float) (seconds * bpm / 60);
+            double const position = pan_video::getFramePosition(beat, startBeat, lengthBeats, frameCount, playForwards);
+            if (playForwards ? position < previous : position > previous) {
+                std::printf("FAILED: trial %d moved against the sweep at %.3f s\n", trial, seconds);
+                failures++;
+                break;
+            }
+            previous = position;
+
+            double const progress = std::min(seconds * bpm / 60 / lengthBeats, 1.0);
+            double const ideal = playForwards ? progress * last : (1 - progress) * last;
+            worstError = std::max(worstError, std::fabs(position - ideal));
+
+            if (beat >= startBeat + lengthBeats) {
+                if (position != (playForwards ? last : 0)) {
+                    std::printf("FAILED: trial %d ended at %.4f, not on the last frame\n", trial, position);
+                    failures++;
+                }
+                break;
+            }
+            seconds += frameSeconds * jitter(random);
+        }
+
+        /* The only error is the float beat's rounding, a small fraction of a frame. */
+        if (worstError > 0.05 && worstError > 0.01 * frameCount / lengthBeats) {
+            std::printf("FAILED: trial %d strayed %.4f frames from the ideal position\n", trial, worstError);
+            failures++;
+        }
+    }
+
+    std::printf("pan_video: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*
+ * Runs 500 tracers with 2,000-point trails for 300 frames: each frame every tracer grows a
+ * head, trims its tail and steps every particle. Compares particle_buffer stepped ring by
+ * ring, the same rings stepped as one batch through Tracer::integrate(), and the deque of
+ * new-ed Particle objects Tracer kept before, and checks all three end up with the same
+ * positions. Also checks that a trail with no velocity or force, as HeadGrowth grows it,
+ * is not reported as moved, so trail_mesh keeps extending it incrementally. Build against
+ * openFrameworks with the addon and its dependencies and run.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "tracer.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static double microsecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+}
+
+static int const TRACERS = 500;
+static int const POINTS = 2000;
+static int const FRAMES = 300;
+
+int main() {
+    ofVec3f const velocity(0.5f, 0.25f, 0);
+    ofVec3f const gravity(0, -0.01f, 0);
+
+    std::vector<particle_buffer> buffers(TRACERS);
+    std::vector<std::unique_ptr<Tracer>> tracers;
+    std::vector<Tracer*> batch;
+    std::vector<std::deque<Particle*>> deques(TRACERS);
+    for (int t = 0; t < TRACERS; t++) {
+        tracers.emplace_back(new Tracer(ofVec3f::zero(), ofVec3f(1920, 1080, 0)));
+        batch.push_back(tracers.back().get());
+        for (int p = 0; p < POINTS; p++) {
+            buffers[t].push_back(ofVec3f(t, p, 0), velocity, 1);
+            tracers[t]->particles.push_back(ofVec3f(t, p, 0), velocity, 1);
+            deques[t].push_back(new Particle(ofVec3f(t, p, 0), velocity, 1));
+        }
+    }
+
+    benchmark_clock::time_point start = benchmark_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        for (auto &buffer : buffers) {
+            buffer.push_back(buffer.back().getLocation(), velocity, 1);
+            buffer.pop_front();
+            buffer.back().applyForce(gravity);
+            buffer[POINTS / 2].applyForce(gravity);
+            buffer.integrate();
+        }
+    }
+    double const bufferMicroseconds = microsecondsSince(start) / FRAMES;
+
+    start = benchmark_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        for (Tracer* t : batch) {
+            particle_buffer& buffer = t->particles;
+            buffer.push_back(buffer.back().getLocation(), velocity, 1);
+            buffer.pop_front();
+            buffer.back().applyForce(gravity);
+            buffer[POINTS / 2].applyForce(gravity);
+        }
+        Tracer::integrate(batch);
+    }
+    double const batchMicroseconds = microsecondsSince(start) / FRAMES;
+
+    start = benchmark_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        for (auto &particles : deques) {
+            particles.push_back(new Particle(particles.back()->location, velocity, 1));
+            delete particles.front();
+            particles.pop_front();
+            particles.back()->applyForce(gravity);
+            particles[POINTS / 2]->applyForce(gravity);
+            for (Particle *particle : particles)
+                particle->update();
+        }
+    }
+    double const dequeMicroseconds = microsecondsSince(start) / FRAMES;
+
+    float difference = 0;
+    for (int t = 0; t < TRACERS; t++) {
+        for (int p = 0; p < POINTS; p++) {
+            difference = std::max(difference, (buffers[t].getLocation(p) - deques[t][p]->location).length());
+            difference = std::max(difference, (tracers[t]->particles.getLocation(p) - deques[t][p]->location).length());
+        }
+        for (Particle *particle : deques[t])
+            delete particle;
+    }
+
+    std::printf("%d tracers x %d points\n", TRACERS, POINTS);
+    std::printf("particle_buffer:      %8.1f us/frame\n", bufferMicroseconds);
+    std::printf("Tracer::integrate():  %8.1f us/frame\n", batchMicroseconds);
+    std::printf("deque of Particle*:   %8.1f us/frame\n", dequeMicroseconds);
+    std::printf("largest position difference %g\n", difference);
+
+    particle_buffer still;
+    for (int p = 0; p < POINTS; p++) {
+        still.push_back(ofVec3f(p, p, 0));
+        still.integrate();
+    }
+    bool const isStillUnmoved = still.getMovedCount() == 0;
+    std::printf("trail without velocity left unmoved: %s\n", isStillUnmoved ? "yes" : "no");
+    return (difference == 0 && isStillUnmoved) ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+/*
+ * Projects 100,000 tracer heads onto a box each frame three ways: the way ProjectOntoBox
+ * used to, building each side's mesh and calling ofxIntersection::LinePlaneIntersection()
+ * for every head, ProjectOntoBox's single update() with its cached planes, and its batch
+ * update(). Reports the time per frame and checks that both new paths land every head where
+ * the old one did, before and after the box is resized, and that a fresh ProjectOntoBox
+ * whose clean() never ran still projects. Build against openFrameworks with
+ * the addon and its dependencies and run.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+#include "ofxIntersection.h"
+#include "tracer.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const HEADS = 100000;
+static int const FRAMES = 20;
+static float const TOLERANCE = 1e-4f;
+
+/* ProjectOntoBox::update() as it was before the plane cache. */
+static ofVec3f projectThroughMeshes(ofBoxPrimitive& box, ofVec3f head) {
+    float const JITTER = 0.0001;
+    int const SCALE = 100000;
+    ofVec3f const MAX_INTERSECTION = {INT_MAX, INT_MAX, INT_MAX};
+    ofxIntersection is;
+    IntersectionData intersection;
+    IsLine line;
+    IsPlane boxSide;
+    if (box.getSize().length() > 0) {
+        ofVec3f closestIntersection = MAX_INTERSECTION;
+        for (int i = 0; i < 6; i++) {
+            auto side = box.getSideMesh(i);
+            boxSide.set(side.getVertices()[0], side.getNormals()[0]);
+            line.set(ofVec3f(0, 0, 0), SCALE * head + JITTER);
+            intersection = is.LinePlaneIntersection(line, boxSide);
+            if (intersection.isIntersection) {
+                if (intersection.pos.length() < closestIntersection.length()) {
+                    closestIntersection = intersection.pos;
+                }
+            }
+        }
+        head += closestIntersection;
+    }
+    return head;
+}
+
+struct scene {
+    explicit scene(const std::vector<ofVec3f>& heads) {
+        for (const ofVec3f& head : heads) {
+            owned.emplace_back(new Tracer(head, ofVec3f(1920, 1080, 1080)));
+            tracers.push_back(owned.back().get());
+        }
+    }
+
+    void reset(const std::vector<ofVec3f>& heads) {
+        for (std::size_t i = 0; i < heads.size(); i++) {
+            tracers[i]->head = heads[i];
+        }
+    }
+
+    std::vector<std::unique_ptr<Tracer>> owned;
+    std::vector<Tracer*> tracers;
+};
+
+template <typename Project>
+static double timeFrames(scene& s, const std::vector<ofVec3f>& heads, Project project) {
+    double total = 0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        s.reset(heads);
+        benchmark_clock::time_point const start = benchmark_clock::now();
+        project(s);
+        total += std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+    }
+    return total / FRAMES;
+}
+
+/* Heads the new paths put further than TOLERANCE, relative to the box, from where the old one did. */
+static int countMismatches(const scene& s, const std::vector<ofVec3f>& expected, float boxSize) {
+    int mismatches = 0;
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        if ((s.tracers[i]->head - expected[i]).length() > TOLERANCE * boxSize)
+            mismatches++;
+    }
+    return mismatches;
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+    std::mt19937 random(15);
+    std::uniform_real_distribution<float> unit(-1, 1);
+    std::vector<ofVec3f> heads;
+    for (int i = 0; i < HEADS; i++) {
+        heads.push_back(ofVec3f(unit(random), unit(random), unit(random)) * 600);
+    }
+
+    ofBoxPrimitive box(400, 300, 200);
+    ProjectOntoBox project(&box);
+    scene old(heads), single(heads), batched(heads);
+    int mismatches = 0;
+    std::printf("%d heads\n", HEADS);
+    std::printf("%-22s %14s %14s %14s\n", "box", "old us/frame", "single us/frame", "batch us/frame");
+    for (int size = 0; size < 2; size++) {
+        if (size == 1)
+            box.set(800, 500, 300);
+        ofVec3f const boxSize = box.getSize();
+
+        double const oldMicroseconds = timeFrames(old, heads, [&](scene& s) {
+            for (Tracer* t : s.tracers) {
+                t->head = projectThroughMeshes(box, t->head);
+            }
+        });
+        double const singleMicroseconds = timeFrames(single, heads, [&](scene& s) {
+            project.clean();
+            for (Tracer* t : s.tracers) {
+                project.update(t, 0);
+            }
+        });
+        std::vector<ofVec3f> expected;
+        for (Tracer* t : old.tracers) {
+            expected.push_back(t->head);
+        }
+        float const largest = std::max(boxSize.x, std::max(boxSize.y, boxSize.z));
+        mismatches += countMismatches(single, expected, largest);
+
+        double const batchedMicroseconds = timeFrames(batched, heads, [&](scene& s) {
+            project.update(s.tracers, 0);
+        });
+        mismatches += countMismatches(batched, expected, largest);
+
+        ProjectOntoBox uncleaned(&box);
+        scene fresh(heads);
+        for (Tracer* t : fresh.tracers) {
+            uncleaned.update(t, 0);
+        }
+        mismatches += countMismatches(fresh, expected, largest);
+
+        char label[32];
+        std::snprintf(label, sizeof(label), "%.0f x %.0f x %.0f", boxSize.x, boxSize.y, boxSize.z);
+        std::printf("%-22s %14.1f %14.1f %14.1f\n", label, oldMicroseconds, singleMicroseconds, batchedMicroseconds);
+    }
+    std::printf("heads away from the old projection: %d\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
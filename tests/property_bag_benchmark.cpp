@@ -0,0 +1,85 @@
+/*
+ * Updates a property_bag of 10,000 properties, each followed by a mirror the way tracer
+ * strategies follow shared controls, with 10 of them set per frame. Times property_bag's
+ * update(), which only cleans what was set and the mirrors that follow, against cleaning
+ * every property and mirror each frame, and checks that both end with the same values.
+ * Build against openFrameworks with the addon and its dependencies and run.
+ */
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+#include "property_bag.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const PROPERTIES = 10000;
+static int const CHANGES = 10;
+static int const FRAMES = 1000;
+
+struct scene {
+    scene() {
+        for (int i = 0; i < PROPERTIES; i++) {
+            sources.emplace_back(new property<float>("control" + ofToString(i), 0, 0, 1));
+            bag.add(sources.back().get());
+            mirrors.emplace_back(new property<float>("mirror" + ofToString(i), *sources.back()));
+        }
+        bag.update();
+    }
+
+    std::vector<std::unique_ptr<property<float>>> sources;
+    std::vector<std::unique_ptr<property<float>>> mirrors;
+    property_bag bag;
+};
+
+template <typename Update>
+static double timeFrames(scene& s, Update update) {
+    std::mt19937 random(17);
+    std::uniform_int_distribution<int> pick(0, PROPERTIES - 1);
+    std::uniform_real_distribution<float> unit(0, 1);
+    double total = 0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        for (int i = 0; i < CHANGES; i++) {
+            s.sources[pick(random)]->set(unit(random));
+        }
+        benchmark_clock::time_point const start = benchmark_clock::now();
+        update(s);
+        total += std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+    }
+    return total / FRAMES;
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+
+    scene dirty;
+    double const dirtyMicroseconds = timeFrames(dirty, [](scene& s) {
+        s.bag.update();
+    });
+
+    scene everything;
+    double const everythingMicroseconds = timeFrames(everything, [](scene& s) {
+        for (auto& source : s.sources) {
+            source->clean();
+        }
+        for (auto& mirror : s.mirrors) {
+            mirror->clean();
+        }
+    });
+
+    bool isSame = true;
+    for (int i = 0; i < PROPERTIES; i++) {
+        if (dirty.mirrors[i]->get() != everything.mirrors[i]->get() || dirty.sources[i]->get() != everything.sources[i]->get())
+            isSame = false;
+    }
+
+    std::printf("%d properties with a mirror each, %d set per frame\n", PROPERTIES, CHANGES);
+    std::printf("%-24s %12s\n", "", "us per frame");
+    std::printf("%-24s %12.1f\n", "dirty list update()", dirtyMicroseconds);
+    std::printf("%-24s %12.1f\n", "clean every property", everythingMicroseconds);
+    std::printf("same values: %s\n", isSame ? "yes" : "no");
+    return isSame ? 0 : 1;
+}
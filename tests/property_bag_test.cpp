@@ -0,0 +1,160 @@
+/*
+ * Checks that chains of mirrors 1 to 10 deep settle in one property_bag::update(), that a
+ * property fed by two changed upstreams is cleaned once, and that destroying properties is
+ * safe: queued ones, deferred ones, mirrors destroyed before the next update and both ends
+ * of a dependency. update() must skip the dead ones and still clean everything else. Run
+ * under AddressSanitizer to catch a dead property being touched. Build against
+ * openFrameworks with the addon and its dependencies and run.
+ */
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "property_bag.h"
+
+using namespace ofxBenG;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static void destroyQueued() {
+    property_bag bag;
+    property<float> source("source", 0, 0, 1);
+    bag.add(&source);
+    std::unique_ptr<property<float>> doomed(new property<float>("doomed", 0, 0, 1));
+    property<float> survivor("survivor", 0, 0, 1);
+    std::unique_ptr<property<float>> alsoDoomed(new property<float>("alsoDoomed", 0, 0, 1));
+    doomed->setDirtyList(source.getDirtyList());
+    survivor.setDirtyList(source.getDirtyList());
+    alsoDoomed->setDirtyList(source.getDirtyList());
+
+    source.set(0.5f);
+    doomed->set(0.5f);
+    survivor.set(0.5f);
+    alsoDoomed->set(0.5f);
+    doomed.reset();
+    alsoDoomed.reset();
+    bag.update();
+    check(source.get() == 0.5f, "property cleaned after one queued before it was destroyed");
+    check(survivor.get() == 0.5f, "property cleaned after its neighbours in the queue were destroyed");
+
+    survivor.set(0.25f);
+    bag.update();
+    check(survivor.get() == 0.25f, "property queued again after its neighbours were destroyed");
+}
+
+static void destroyDeferred() {
+    property_bag bag;
+    property<float> source("source", 0, 0, 1);
+    bag.add(&source);
+    property<float> mirror("mirror", source);
+    std::unique_ptr<property<float>> doomed(new property<float>("doomed", 0, 0, 1));
+    property<float> survivor("survivor", 0, 0, 1);
+    doomed->setDirtyList(source.getDirtyList());
+    survivor.setDirtyList(source.getDirtyList());
+
+    /* Set from a rank 1 subscriber, these rank 0 properties are deferred to the next update. */
+    mirror.addSubscriber([&]() {
+        if (doomed)
+            doomed->set(mirror.get());
+        survivor.set(mirror.get());
+    });
+    source.set(0.75f);
+    bag.update();
+    check(mirror.get() == 0.75f, "mirror cleaned in the same update as its source");
+    check(survivor.get() == 0, "property set below its rank deferred to the next update");
+
+    doomed.reset();
+    bag.update();
+    check(survivor.get() == 0.75f, "deferred property cleaned after another deferred one was destroyed");
+}
+
+static void settleChains() {
+    for (int depth = 1; depth <= 10; depth++) {
+        property_bag bag;
+        property<float> source("source", 0, 0, 1);
+        bag.add(&source);
+        std::vector<std::unique_ptr<property<float>>> chain;
+        property<float>* upstream = &source;
+        for (int i = 0; i < depth; i++) {
+            chain.emplace_back(new property<float>("link" + ofToString(i), *upstream));
+            upstream = chain.back().get();
+        }
+        bag.update();
+
+        source.set(0.5f);
+        bag.update();
+        bool isSettled = true;
+        for (auto& link : chain) {
+            isSettled = isSettled && link->get() == 0.5f;
+        }
+        if (!isSettled)
+            std::printf("chain of %d: ", depth);
+        check(isSettled, "chain settled in one update");
+    }
+}
+
+static void coalesceUpstreams() {
+    property_bag bag;
+    property<float> source("source", 0, 0, 1);
+    bag.add(&source);
+    property<float> left("left", source);
+    property<float> right("right", source);
+    property<float> joined("joined", left);
+    joined.dependOn(&right);
+    right.addSubscriber([&]() { joined.set(right.get()); }, &joined);
+    int cleans = 0;
+    joined.addSubscriber([&]() { cleans++; });
+    bag.update();
+    cleans = 0;
+
+    source.set(0.5f);
+    bag.update();
+    check(joined.get() == 0.5f, "property fed by two upstreams settled in one update");
+    check(cleans == 1, "property fed by two changed upstreams cleaned once");
+}
+
+static void destroyMirrors() {
+    property_bag bag;
+    property<float> source("source", 0, 0, 1);
+    bag.add(&source);
+
+    /* Constructing a mirror queues it on the bag's dirty list and subscribes it to source. */
+    std::unique_ptr<property<float>> doomed(new property<float>("doomed", source));
+    property<float> survivor("survivor", source);
+    std::unique_ptr<property<float>> middle(new property<float>("middle", survivor));
+    property<float> tail("tail", *middle);
+    doomed.reset();
+    source.set(0.5f);
+    bag.update();
+    check(survivor.get() == 0.5f, "mirror cleaned after a mirror of the same source was destroyed");
+    check(tail.get() == 0.5f, "end of a chain settled");
+
+    middle.reset();
+    source.set(0.25f);
+    bag.update();
+    check(survivor.get() == 0.25f, "mirror follows its source after its own mirror was destroyed");
+    check(tail.get() == 0.5f, "mirror cut off from its destroyed upstream keeps its value");
+
+    /* The upstream goes first; the mirror's destructor must not reach back to it. */
+    std::unique_ptr<property<float>> upstream(new property<float>("upstream", 0, 0, 1));
+    std::unique_ptr<property<float>> downstream(new property<float>("downstream", *upstream));
+    upstream.reset();
+    downstream.reset();
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+    settleChains();
+    coalesceUpstreams();
+    destroyQueued();
+    destroyDeferred();
+    destroyMirrors();
+    std::printf("property_bag: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+/*
+ * Morphs a property_bag of 5,000 properties, each followed by a mirror, through three
+ * presets that cover 4,000 of them, one frame at a time. Times property_morph::update() plus
+ * the bag's update() against looking each property up in the presets and setting its
+ * interpolated scale one at a time. Checks that the morph ends on the last preset and that
+ * properties the presets leave out keep their initial scale and are never set. Build against
+ * openFrameworks with the addon and its dependencies and run.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "property_morph.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const PROPERTIES = 5000;
+static int const COVERED = 4000;
+static int const PRESETS = 3;
+static float const BEATS_PER_LEG = 8;
+static int const FRAMES_PER_BEAT = 30;
+
+struct scene {
+    scene() {
+        for (int i = 0; i < PROPERTIES; i++) {
+            properties.emplace_back(new property<float>("property" + ofToString(i), 0.5f, 0, 1));
+            bag.add(properties.back().get());
+            mirrors.emplace_back(new property<float>("mirror" + ofToString(i), *properties.back()));
+        }
+        bag.update();
+        for (int p = 0; p < PRESETS; p++) {
+            std::shared_ptr<property_snapshot> preset(new property_snapshot());
+            for (int i = 0; i < COVERED; i++) {
+                preset->add("property" + ofToString(i), (float) ((i * 31 + p * 17) % 100) / 100);
+            }
+            preset->sortByHash();
+            presets.push_back(preset);
+        }
+    }
+
+    std::vector<std::unique_ptr<property<float>>> properties;
+    std::vector<std::unique_ptr<property<float>>> mirrors;
+    property_bag bag;
+    std::vector<std::shared_ptr<const property_snapshot>> presets;
+};
+
+static float findScale(const property_snapshot& preset, uint64_t hash, float fallback) {
+    property_snapshot::entries_view const entries = preset.getEntries();
+    auto match = std::lower_bound(entries.begin(), entries.end(), hash, [](const property_snapshot::entry& e, uint64_t h) {
+        return e.nameHash < h;
+    });
+    return (match != entries.end() && match->nameHash == hash) ? match->scale : fallback;
+}
+
+template <typename Frame>
+static double timeMorph(scene& s, Frame frame) {
+    int const frames = (int) (BEATS_PER_LEG * (PRESETS - 1)) * FRAMES_PER_BEAT;
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    for (int i = 0; i <= frames; i++) {
+        frame(s, (float) i / FRAMES_PER_BEAT);
+        s.bag.update();
+    }
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count() / (frames + 1);
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+
+    scene batched;
+    int uncoveredSets = 0;
+    for (int i = COVERED; i < PROPERTIES; i++) {
+        batched.properties[i]->addSubscriber([&]() { uncoveredSets++; });
+    }
+    property_morph morph(batched.bag);
+    morph.start(batched.presets, 0, BEATS_PER_LEG);
+    double const batchedMicroseconds = timeMorph(batched, [&](scene& s, float beat) {
+        morph.update(beat);
+    });
+
+    scene oneByOne;
+    std::vector<uint64_t> hashes;
+    std::vector<float> initial;
+    for (auto& p : oneByOne.properties) {
+        hashes.push_back(property_snapshot::hashName(p->getName()));
+        initial.push_back(p->getScale());
+    }
+    double const oneByOneMicroseconds = timeMorph(oneByOne, [&](scene& s, float beat) {
+        float const position = std::min(beat / BEATS_PER_LEG, (float) (PRESETS - 1));
+        int const leg = std::min((int) position, PRESETS - 2);
+        float const t = position - leg;
+        for (int i = 0; i < PROPERTIES; i++) {
+            float const from = findScale(*s.presets[leg], hashes[i], initial[i]);
+            float const to = findScale(*s.presets[leg + 1], hashes[i], initial[i]);
+            s.properties[i]->setScale(from * (1.0f - t) + to * t);
+        }
+    });
+
+    int mismatches = 0;
+    const property_snapshot& last = *batched.presets.back();
+    for (int i = 0; i < PROPERTIES; i++) {
+        float const expected = findScale(last, hashes[i], 0.5f);
+        if (batched.properties[i]->getScale() != expected || oneByOne.properties[i]->getScale() != expected)
+            mismatches++;
+    }
+
+    std::printf("%d properties with a mirror each, %d in %d presets\n", PROPERTIES, COVERED, PRESETS);
+    std::printf("%-30s %12s\n", "", "us per frame");
+    std::printf("%-30s %12.1f\n", "property_morph", batchedMicroseconds);
+    std::printf("%-30s %12.1f\n", "one property at a time", oneByOneMicroseconds);
+    std::printf("scales off the last preset: %d, uncovered properties set: %d\n", mismatches, uncoveredSets);
+    return mismatches == 0 && uncoveredSets == 0 ? 0 : 1;
+}
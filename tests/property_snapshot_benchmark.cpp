@@ -0,0 +1,106 @@
+/*
+ * Saves and loads the scales of a property_bag of 10,000 properties through the XML path and
+ * through binary snapshots. For XML both steps run on the calling thread. For snapshots it
+ * times what the calling thread pays: capture() and queueing in saveSnapshot(), the
+ * memory-mapped loadSnapshot(), and the update() that applies a switchTo(). It also times the
+ * background write on its own. Checks that the preset applied from the file restores every
+ * saved scale. Build against openFrameworks with the addon and its dependencies and run.
+ */
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "property_bag.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const PROPERTIES = 10000;
+static int const REPEATS = 10;
+
+static double microsecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+}
+
+struct scene {
+    scene() {
+        for (int i = 0; i < PROPERTIES; i++) {
+            properties.emplace_back(new property<float>("property" + ofToString(i), 0, 0, 1));
+            bag.add(properties.back().get());
+        }
+    }
+
+    void setScales(float offset) {
+        for (int i = 0; i < PROPERTIES; i++) {
+            properties[i]->setScale((float) ((i * 37) % 1000) / 1000 * 0.5f + offset);
+        }
+        bag.update();
+    }
+
+    std::vector<std::unique_ptr<property<float>>> properties;
+    property_bag bag;
+};
+
+template <typename Step>
+static double timeRepeats(Step step) {
+    double total = 0;
+    for (int i = 0; i < REPEATS; i++) {
+        benchmark_clock::time_point const start = benchmark_clock::now();
+        step();
+        total += microsecondsSince(start);
+    }
+    return total / REPEATS;
+}
+
+static void report(const char* label, double microseconds) {
+    std::printf("%-34s %12.1f\n", label, microseconds);
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+    scene s;
+    s.setScales(0.25f);
+    std::vector<float> saved;
+    for (auto& p : s.properties) {
+        saved.push_back(p->getScale());
+    }
+
+    double const xmlSave = timeRepeats([&]() { s.bag.saveToXml("property_snapshot_benchmark.xml"); });
+    double const xmlLoad = timeRepeats([&]() { s.bag.loadFromXml("property_snapshot_benchmark.xml"); });
+
+    double const capture = timeRepeats([&]() { s.bag.capture(); });
+    double const queueSave = timeRepeats([&]() { s.bag.saveSnapshot("property_snapshot_benchmark.bin"); });
+    std::shared_ptr<property_snapshot> snapshot = s.bag.capture();
+    double const write = timeRepeats([&]() { snapshot->save("property_snapshot_benchmark.bin"); });
+
+    std::shared_ptr<const property_snapshot> preset;
+    double const load = timeRepeats([&]() { preset = property_bag::loadSnapshot("property_snapshot_benchmark.bin"); });
+    double apply = 0;
+    for (int i = 0; i < REPEATS; i++) {
+        s.setScales(0.5f);
+        benchmark_clock::time_point const start = benchmark_clock::now();
+        s.bag.switchTo(preset);
+        s.bag.update();
+        apply += microsecondsSince(start);
+    }
+    apply /= REPEATS;
+
+    int mismatches = preset ? 0 : PROPERTIES;
+    for (int i = 0; preset && i < PROPERTIES; i++) {
+        if (s.properties[i]->getScale() != saved[i])
+            mismatches++;
+    }
+
+    std::printf("%d properties\n", PROPERTIES);
+    std::printf("%-34s %12s\n", "", "us");
+    report("XML save", xmlSave);
+    report("XML load", xmlLoad);
+    report("snapshot capture()", capture);
+    report("saveSnapshot() on the caller", queueSave);
+    report("snapshot write, background", write);
+    report("loadSnapshot()", load);
+    report("switchTo() and update()", apply);
+    std::printf("scales not restored: %d\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+/*
+ * Hammers property<T>::set() from a controller thread while the render thread calls clean(),
+ * and += from two controller threads at once. Vectors are always set with equal components,
+ * so a torn value shows up as unequal ones. The render thread must never see a torn or older
+ * value, nor one out of range, must pick up the final value after the writers stop, and no
+ * increment may be lost. The log sink must only ever run on the cleaning thread. Build
+ * against openFrameworks with the addon and its dependencies and run.
+ */
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "property.h"
+
+using namespace ofxBenG;
+
+static int const SETS = 500000;
+static int const INCREMENTS = 100000;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what, float value) {
+    if (!condition) {
+        if (failures < 20)
+            std::printf("FAILED: %s (%g)\n", what, value);
+        failures++;
+    }
+}
+
+static bool isWhole(const ofVec3f& v) {
+    return v.x == v.y && v.y == v.z;
+}
+
+static void setWhileCleaning() {
+    property<ofVec3f> position("position", ofVec3f::zero(), ofVec3f::zero(), ofVec3f(SETS, SETS, SETS));
+    std::atomic<bool> isSetting = {true};
+    std::thread controller([&] {
+        for (int i = 1; i <= SETS; i++)
+            position.set(ofVec3f(i, i, i));
+        /* Out of range, so it must never reach clean(). */
+        position.set(ofVec3f(2 * SETS, 2 * SETS, 2 * SETS));
+        isSetting.store(false);
+    });
+
+    float last = 0;
+    int changes = 0;
+    position.addSubscriber([&]() {
+        ofVec3f const v = position.get();
+        check(isWhole(v), "clean() applied a torn value", v.x);
+        check(v.x > last, "clean() applied an older value", v.x);
+        check(v.x <= SETS, "clean() applied a value out of range", v.x);
+        last = v.x;
+        changes++;
+    });
+    while (isSetting.load()) {
+        position.clean();
+        /* map(int, ...) reads the latest value set from any thread on the render thread. */
+        ofVec3f const latest = position.map(0, 0, 0, 1);
+        check(latest.y == latest.z, "map() read a torn value", latest.y);
+    }
+    controller.join();
+    position.clean();
+    check(position.get().x == SETS, "clean() missed the final value", position.get().x);
+    std::printf("set(): %d values set, %d seen by clean()\n", SETS, changes);
+}
+
+static void incrementFromTwoThreads() {
+    property<int> count("count", 0, 0, 2 * INCREMENTS);
+    std::atomic<int> writing = {2};
+    auto increment = [&] {
+        for (int i = 0; i < INCREMENTS; i++)
+            count += 1;
+        writing.fetch_sub(1);
+    };
+    std::thread first(increment);
+    std::thread second(increment);
+    int last = 0;
+    while (writing.load() > 0) {
+        count.clean();
+        check(count.get() >= last, "count went backwards", count.get());
+        last = count.get();
+    }
+    first.join();
+    second.join();
+    count.clean();
+    check(count.get() == 2 * INCREMENTS, "+= lost increments", count.get());
+}
+
+int main() {
+    std::thread::id const renderThread = std::this_thread::get_id();
+    std::atomic<int> offThreadLogs = {0};
+    property_base::setLogSink([&](const std::string&, const std::string&) {
+        if (std::this_thread::get_id() != renderThread)
+            offThreadLogs++;
+    });
+    setWhileCleaning();
+    incrementFromTwoThreads();
+    check(offThreadLogs.load() == 0, "log sink ran on a controller thread", offThreadLogs.load());
+    std::printf("property: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
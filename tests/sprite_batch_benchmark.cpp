@@ -0,0 +1,118 @@
+/*
+ * Opens a hidden window and draws 64 tracers of 200 pizza sprites each three ways: one
+ * ofImage::draw() per particle as DrawPizza did before, DrawPizza flushing its own batch
+ * after each tracer, and DrawPizza queueing onto the tracer_system's shared batch, which
+ * draw() flushes once at the end of the frame. Reports draw calls and frame time; glFinish()
+ * closes every frame so GPU time is included. Needs openFrameworks and a GL driver; on a
+ * server, run it under a virtual display such as xvfb-run with Mesa.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "ofMain.h"
+#include "tracer_system.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static double microsecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+}
+
+static int const TRACERS = 64;
+static int const PARTICLES = 200;
+static int const FRAMES = 60;
+
+template <typename Draw>
+static double timeFrames(Draw draw) {
+    draw();
+    glFinish();
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        draw();
+        glFinish();
+    }
+    return microsecondsSince(start) / FRAMES;
+}
+
+/* The old DrawPizza: one bind and one draw call per particle. */
+class DrawPizzaEach : public TracerDrawStrategy {
+public:
+    DrawPizzaEach(ofImage& pizza) : pizza(pizza) {}
+
+    void draw(Tracer* t, float time, std::shared_ptr<ofBaseRenderer> renderer) {
+        for (std::size_t i = 0; i < t->particles.size(); i++) {
+            ofVec3f const location = t->particles.getLocation(i);
+            pizza.draw(location.x, location.y);
+        }
+    }
+
+private:
+    ofImage& pizza;
+};
+
+static void fill(tracer_system& system, ofVec3f stage) {
+    for (int i = 0; i < TRACERS; i++) {
+        Tracer* t = system.add(new Tracer(ofVec3f::zero(), stage));
+        for (int j = 0; j < PARTICLES; j++) {
+            float const angle = (i * PARTICLES + j) * 0.013f;
+            t->particles.push_back(ofVec3f(stage.x / 2 + std::cos(angle) * (100 + i * 4),
+                                           stage.y / 2 + std::sin(angle * 1.7f) * (80 + i * 3), 0));
+        }
+    }
+}
+
+int main() {
+    ofGLFWWindowSettings settings;
+    settings.setGLVersion(3, 2);
+    settings.visible = false;
+    settings.width = 1280;
+    settings.height = 720;
+    ofCreateWindow(settings);
+    std::shared_ptr<ofBaseRenderer> renderer = ofGetCurrentRenderer();
+    ofVec3f const stage(1280, 720, 0);
+
+    ofPixels pixels;
+    pixels.allocate(32, 32, OF_PIXELS_RGBA);
+    pixels.setColor(ofColor(255, 160, 0, 200));
+    ofImage pizza;
+    pizza.setFromPixels(pixels);
+
+    tracer_system eachSystem(0, 1);
+    fill(eachSystem, stage);
+    DrawPizzaEach each(pizza);
+    tracer_system ownSystem(0, 1);
+    fill(ownSystem, stage);
+    std::vector<std::unique_ptr<DrawPizza>> own;
+    tracer_system sharedSystem(0, 1);
+    fill(sharedSystem, stage);
+    DrawPizza shared(pizza, sharedSystem.getSpriteBatch());
+    for (std::size_t i = 0; i < TRACERS; i++) {
+        eachSystem.getTracer(i)->addDrawBehavior(&each);
+        own.emplace_back(new DrawPizza(pizza));
+        ownSystem.getTracer(i)->addDrawBehavior(own.back().get());
+        sharedSystem.getTracer(i)->addDrawBehavior(&shared);
+    }
+
+    double const eachMicroseconds = timeFrames([&] {
+        eachSystem.draw(0, renderer);
+    });
+    double const ownMicroseconds = timeFrames([&] {
+        ownSystem.draw(0, renderer);
+    });
+    sharedSystem.getSpriteBatch().resetDrawCallCount();
+    double const sharedMicroseconds = timeFrames([&] {
+        sharedSystem.draw(0, renderer);
+    });
+    int const sharedDrawCalls = sharedSystem.getSpriteBatch().getDrawCallCount() / (FRAMES + 1);
+
+    std::printf("%d tracers x %d sprites\n", TRACERS, PARTICLES);
+    std::printf("%-22s %12s %12s\n", "", "draw calls", "frame us");
+    std::printf("%-22s %12d %12.1f\n", "ofImage::draw each", TRACERS * PARTICLES, eachMicroseconds);
+    std::printf("%-22s %12d %12.1f\n", "batch per tracer", TRACERS, ownMicroseconds);
+    std::printf("%-22s %12d %12.1f\n", "shared batch", sharedDrawCalls, sharedMicroseconds);
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Schedules 100k actions across a simulated ten-minute set at 120 bpm and 60 fps, then
+ * dispatches them frame by frame, once through timing_wheel as beat_action uses it and
+ * once through the std::priority_queue it replaced. Reports insert cost and the mean, p99
+ * and worst per-frame dispatch cost for both. The whole set is replayed a few times and
+ * each frame keeps its fastest run, so the worst frame is the scheduler's, not a
+ * preemption's.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <queue>
+#include <random>
+#include <vector>
+#include "timing_wheel.h"
+
+using namespace ofxBenG;
+
+struct action {
+    float beat;
+    action *next;
+};
+
+struct action_traits {
+    static float keyOf(action *a) {
+        return a->beat;
+    }
+
+    static action *&nextOf(action *a) {
+        return a->next;
+    }
+};
+
+struct later_beat {
+    bool operator()(const action *first, const action *second) const {
+        return first->beat > second->beat;
+    }
+};
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static double microsecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+}
+
+static std::size_t const ACTIONS = 100000;
+static double const BPM = 120;
+static double const FPS = 60;
+static int const FRAMES = (int) (10 * 60 * FPS) + 1;
+static int const TICKS_PER_BEAT = 64;
+static int const REPEATS = 5;
+
+static void report(const char *name, double insertMicroseconds, const std::vector<double> &frameMicroseconds, std::size_t dispatched) {
+    std::vector<double> sorted(frameMicroseconds);
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (double frame : sorted) {
+        total += frame;
+    }
+    std::printf("%-14s insert %5.1f ns/action  dispatch %.3f us/frame mean, %.3f us p99, %.1f us worst  (%zu dispatched)\n",
+                name, 1000 * insertMicroseconds / ACTIONS, total / sorted.size(), sorted[sorted.size() * 99 / 100],
+                sorted.back(), dispatched);
+}
+
+int main() {
+    std::mt19937 random(1);
+    float const setBeats = (float) ((FRAMES - 1) / FPS * BPM / 60);
+    std::uniform_real_distribution<float> beatOf(0, setBeats);
+    std::vector<action> actions(ACTIONS);
+    for (auto &a : actions) {
+        a.beat = beatOf(random);
+        a.next = nullptr;
+    }
+
+    std::vector<double> frameMicroseconds(FRAMES);
+    std::vector<action *> expired;
+    expired.reserve(ACTIONS);
+
+    {
+        double insertMicroseconds = 0;
+        std::size_t dispatched = 0;
+        std::fill(frameMicroseconds.begin(), frameMicroseconds.end(), 1e30);
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            timing_wheel<action, float, action_traits> wheel(TICKS_PER_BEAT);
+            benchmark_clock::time_point start = benchmark_clock::now();
+            for (auto &a : actions) {
+                wheel.insert(&a, 0);
+            }
+            insertMicroseconds = microsecondsSince(start);
+
+            dispatched = 0;
+            for (int frame = 0; frame < FRAMES; frame++) {
+                float const beat = (float) (frame / FPS * BPM / 60);
+                start = benchmark_clock::now();
+                expired.clear();
+                wheel.advance(beat, expired);
+                frameMicroseconds[frame] = std::min(frameMicroseconds[frame], microsecondsSince(start));
+                dispatched += expired.size();
+            }
+        }
+        report("timing_wheel", insertMicroseconds, frameMicroseconds, dispatched);
+    }
+
+    {
+        double insertMicroseconds = 0;
+        std::size_t dispatched = 0;
+        std::fill(frameMicroseconds.begin(), frameMicroseconds.end(), 1e30);
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            std::priority_queue<action *, std::vector<action *>, later_beat> heap;
+            benchmark_clock::time_point start = benchmark_clock::now();
+            for (auto &a : actions) {
+                heap.push(&a);
+            }
+            insertMicroseconds = microsecondsSince(start);
+
+            dispatched = 0;
+            for (int frame = 0; frame < FRAMES; frame++) {
+                float const beat = (float) (frame / FPS * BPM / 60);
+                start = benchmark_clock::now();
+                expired.clear();
+                while (!heap.empty() && heap.top()->beat <= beat) {
+                    expired.push_back(heap.top());
+                    heap.pop();
+                }
+                frameMicroseconds[frame] = std::min(frameMicroseconds[frame], microsecondsSince(start));
+                dispatched += expired.size();
+            }
+        }
+        report("priority_queue", insertMicroseconds, frameMicroseconds, dispatched);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * Runs the same eight update strategies over 2,000 tracers three ways: each tracer's
+ * runtime list of virtual strategies, a tracer_pipeline called once per tracer, and the
+ * pipeline's batch update(), which runs stage by stage and uses the batch paths of
+ * PerlinMovement and ProjectOntoBox. Reports the mean time per frame and checks that all
+ * three end with the same heads. Build against openFrameworks with the addon and its
+ * dependencies and run.
+ */
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "tracer_pipeline.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const TRACERS = 2000;
+static int const FRAMES = 300;
+
+typedef tracer_pipeline<PerlinMovement, MapDimension, MapDimension, MapDimension, ProjectOntoBox, HeadGrowth, MaximumLength, CurvedPath> eight_stages;
+
+struct scene {
+    scene()
+        : box(400, 400, 400),
+          movement(velocity, ofVec3f(0.5f, 1.5f, 2.5f), unit, unit, unit),
+          mapX(0, spread),
+          mapY(1, spread),
+          mapZ(2, spread),
+          project(&box),
+          length(maxPoints),
+          pipeline(&movement, &mapX, &mapY, &mapZ, &project, &growth, &length, &curve) {
+        for (int i = 0; i < TRACERS; i++) {
+            Tracer* t = new Tracer(ofVec3f(i % 40 - 20.0f, i / 40 - 25.0f, 1), ofVec3f(1920, 1080, 1080));
+            t->addUpdateBehavior(&movement);
+            t->addUpdateBehavior(&mapX);
+            t->addUpdateBehavior(&mapY);
+            t->addUpdateBehavior(&mapZ);
+            t->addUpdateBehavior(&project);
+            t->addUpdateBehavior(&growth);
+            t->addUpdateBehavior(&length);
+            t->addUpdateBehavior(&curve);
+            owned.emplace_back(t);
+            tracers.push_back(t);
+        }
+    }
+
+    property<ofVec3f> velocity = {"velocity", ofVec3f(0.002f, 0.003f, 0.001f), ofVec3f::zero(), ofVec3f(1, 1, 1)};
+    property<ofVec2f> unit = {"unit", ofVec2f(-0.5f, 0.5f), ofVec2f(-1, -1), ofVec2f(1, 1)};
+    property<ofVec2f> spread = {"spread", ofVec2f(-0.5f, 0.5f), ofVec2f(-1, -1), ofVec2f(1, 1)};
+    property<int> maxPoints = {"maxPoints", 100, 0, 1000};
+    ofBoxPrimitive box;
+    PerlinMovement movement;
+    MapDimension mapX, mapY, mapZ;
+    ProjectOntoBox project;
+    HeadGrowth growth;
+    MaximumLength length;
+    CurvedPath curve;
+    eight_stages pipeline;
+    std::vector<std::unique_ptr<Tracer>> owned;
+    std::vector<Tracer*> tracers;
+};
+
+template <typename Update>
+static double timeFrames(scene& s, Update update) {
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        update(s, (float) frame);
+    }
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count() / FRAMES;
+}
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+
+    scene virtualCalls;
+    double const virtualMicroseconds = timeFrames(virtualCalls, [](scene& s, float time) {
+        for (Tracer* t : s.tracers) {
+            t->update(time);
+        }
+    });
+
+    scene perTracer;
+    double const perTracerMicroseconds = timeFrames(perTracer, [](scene& s, float time) {
+        s.pipeline.clean();
+        for (Tracer* t : s.tracers) {
+            s.pipeline.update(t, time);
+        }
+    });
+
+    scene batched;
+    double const batchedMicroseconds = timeFrames(batched, [](scene& s, float time) {
+        s.pipeline.update(s.tracers, time);
+    });
+
+    bool isSame = true;
+    for (int i = 0; i < TRACERS; i++) {
+        ofVec3f const expected = virtualCalls.tracers[i]->head;
+        if (perTracer.tracers[i]->head != expected || batched.tracers[i]->head != expected)
+            isSame = false;
+    }
+
+    std::printf("%d tracers, 8 strategies\n", TRACERS);
+    std::printf("%-24s %12s\n", "", "us per frame");
+    std::printf("%-24s %12.1f\n", "virtual per tracer", virtualMicroseconds);
+    std::printf("%-24s %12.1f\n", "pipeline per tracer", perTracerMicroseconds);
+    std::printf("%-24s %12.1f\n", "pipeline batch", batchedMicroseconds);
+    std::printf("same heads: %s\n", isSame ? "yes" : "no");
+    return isSame ? 0 : 1;
+}
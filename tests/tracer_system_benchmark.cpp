@@ -0,0 +1,84 @@
+/*
+ * Updates 4,000 tracers, each with its own PerlinMovement, MapDimension, HeadGrowth and
+ * MaximumLength, on tracer_systems of 1, 2, 4, 8 and 16 threads and reports the mean update
+ * time per frame and the speedup over one thread. Also checks that every thread count ends
+ * with the same heads and trail lengths. Threads beyond the machine's cores only add
+ * contention; the printout says how many cores there are. Build against openFrameworks with
+ * the addon and its dependencies and run.
+ */
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "tracer_system.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const TRACERS = 4000;
+static int const WARM_UP_FRAMES = 120;
+static int const FRAMES = 300;
+
+struct scene {
+    explicit scene(std::size_t threads) : system(1, threads) {
+        for (int i = 0; i < TRACERS; i++) {
+            Tracer* t = system.add(new Tracer(ofVec3f::zero(), ofVec3f(1920, 1080, 0)));
+            PerlinMovement* movement = new PerlinMovement(velocity, ofVec3f(i * 0.37f, i * 0.71f, i * 0.13f), unit, unit, unit);
+            MapDimension* mapX = new MapDimension(0, width);
+            HeadGrowth* growth = new HeadGrowth();
+            MaximumLength* length = new MaximumLength(maxPoints);
+            strategies.emplace_back(movement);
+            strategies.emplace_back(mapX);
+            strategies.emplace_back(growth);
+            strategies.emplace_back(length);
+            t->addUpdateBehavior(movement);
+            t->addUpdateBehavior(mapX);
+            t->addUpdateBehavior(growth);
+            t->addUpdateBehavior(length);
+        }
+    }
+
+    property<ofVec3f> velocity = {"velocity", ofVec3f(0.002f, 0.003f, 0.001f), ofVec3f::zero(), ofVec3f(1, 1, 1)};
+    property<ofVec2f> unit = {"unit", ofVec2f(-0.5f, 0.5f), ofVec2f(-1, -1), ofVec2f(1, 1)};
+    property<ofVec2f> width = {"width", ofVec2f(0, 1920), ofVec2f(0, 0), ofVec2f(1920, 1920)};
+    property<int> maxPoints = {"maxPoints", 200, 0, 1000};
+    std::vector<std::unique_ptr<TracerUpdateStrategy>> strategies;
+    tracer_system system;
+};
+
+int main() {
+    property_base::setLogSink(property_base::log_sink());
+    std::printf("%u hardware threads, %d tracers\n", std::thread::hardware_concurrency(), TRACERS);
+    std::printf("%8s %14s %10s\n", "threads", "us per frame", "speedup");
+
+    double singleThreadMicroseconds = 0;
+    std::vector<ofVec3f> expectedHeads;
+    bool isDeterministic = true;
+    for (std::size_t threads = 1; threads <= 16; threads *= 2) {
+        scene s(threads);
+        for (int frame = 0; frame < WARM_UP_FRAMES; frame++) {
+            s.system.update(frame);
+        }
+        benchmark_clock::time_point const start = benchmark_clock::now();
+        for (int frame = WARM_UP_FRAMES; frame < WARM_UP_FRAMES + FRAMES; frame++) {
+            s.system.update(frame);
+        }
+        double const microseconds = std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count() / FRAMES;
+
+        for (int i = 0; i < TRACERS; i++) {
+            Tracer* t = s.system.getTracer(i);
+            if (threads == 1) {
+                expectedHeads.push_back(t->head);
+            } else if (t->head != expectedHeads[i] || t->particles.size() != 200) {
+                isDeterministic = false;
+            }
+        }
+        if (threads == 1)
+            singleThreadMicroseconds = microseconds;
+        std::printf("%8zu %14.1f %9.2fx\n", threads, microseconds, singleThreadMicroseconds / microseconds);
+    }
+    std::printf("same result on every thread count: %s\n", isDeterministic ? "yes" : "no");
+    return isDeterministic ? 0 : 1;
+}
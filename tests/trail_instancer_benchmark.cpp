@@ -0,0 +1,89 @@
+/*
+ * Opens a hidden GL 3.2 window and times drawing one 2,000-point trail with multiplierCount
+ * set from 1 to 256: one instanced draw, the fallback that draws the trail's VBO once per
+ * translated copy, and one ofPath draw per copy as Multiplier did before. glFinish() closes every frame so GPU time is included.
+ * Needs openFrameworks and a GL driver; on a server, run it under a virtual display such as
+ * xvfb-run with Mesa.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "ofMain.h"
+#include "trail_instancer.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static double microsecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+}
+
+static int const POINTS = 2000;
+static int const FRAMES = 60;
+
+template <typename Draw>
+static double timeFrames(Draw draw) {
+    draw();
+    glFinish();
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        draw();
+        glFinish();
+    }
+    return microsecondsSince(start) / FRAMES;
+}
+
+int main() {
+    ofGLFWWindowSettings settings;
+    settings.setGLVersion(3, 2);
+    settings.visible = false;
+    ofCreateWindow(settings);
+
+    particle_buffer particles;
+    ofPath path;
+    path.setFilled(false);
+    path.setStrokeColor(ofColor::white);
+    path.moveTo(ofVec3f::zero());
+    for (int i = 0; i < POINTS; i++) {
+        ofVec3f const point(std::cos(i * 0.05f) * 300, std::sin(i * 0.07f) * 200, 0);
+        particles.push_back(point);
+        path.curveTo(point);
+    }
+    trail_mesh trail;
+    trail.sync(particles, path.getCurveResolution());
+
+    std::printf("%6s %16s %16s %16s\n", "copies", "instanced us", "translated us", "per-copy us");
+    for (int copies = 1; copies <= 256; copies *= 2) {
+        std::vector<ofVec3f> offsets;
+        for (int i = 0; i < copies; i++)
+            offsets.push_back(ofVec3f(i % 16 * 10.0f, i / 16 * 10.0f, 0));
+
+        trail_instancer instanced;
+        instanced.setMode(trail_instancer::INSTANCED);
+        instanced.setOffsets(offsets);
+        double const instancedMicroseconds = timeFrames([&] {
+            instanced.draw(trail, path, copies);
+        });
+
+        trail_instancer translated;
+        translated.setMode(trail_instancer::TRANSLATED);
+        translated.setOffsets(offsets);
+        double const translatedMicroseconds = timeFrames([&] {
+            translated.draw(trail, path, copies);
+        });
+
+        double const perCopyMicroseconds = timeFrames([&] {
+            for (auto &offset : offsets) {
+                ofPushMatrix();
+                ofTranslate(offset);
+                path.draw();
+                ofPopMatrix();
+            }
+        });
+
+        std::printf("%6d %16.1f %16.1f %16.1f\n", copies, instancedMicroseconds, translatedMicroseconds, perCopyMicroseconds);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Measures the per-frame cost of keeping one trail's curve up to date as the trail grows
+ * from 100 to 8,000 points: trail_mesh::sync() against clearing and re-tessellating the
+ * whole ofPath every frame, which is what CurvedPath did before. Each frame appends a head
+ * and trims the tail, as HeadGrowth and MaximumLength do. Needs openFrameworks.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "trail_mesh.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static double microsecondsSince(benchmark_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(benchmark_clock::now() - start).count();
+}
+
+static int const FRAMES = 200;
+static int const RESOLUTION = 20;
+
+static ofVec3f pointAt(int i) {
+    return ofVec3f(std::cos(i * 0.05f) * 300, std::sin(i * 0.07f) * 200, i * 0.1f);
+}
+
+int main() {
+    int const lengths[] = {100, 500, 1000, 2000, 4000, 8000};
+    std::printf("%8s %16s %16s\n", "points", "sync us/frame", "ofPath us/frame");
+    for (int length : lengths) {
+        particle_buffer particles;
+        for (int i = 0; i < length; i++)
+            particles.push_back(pointAt(i));
+
+        trail_mesh trail;
+        trail.sync(particles, RESOLUTION);
+        std::size_t sink = 0;
+        int next = length;
+        benchmark_clock::time_point start = benchmark_clock::now();
+        for (int frame = 0; frame < FRAMES; frame++) {
+            particles.push_back(pointAt(next++));
+            particles.pop_front();
+            trail.sync(particles, RESOLUTION);
+            sink += trail.size();
+        }
+        double const syncMicroseconds = microsecondsSince(start) / FRAMES;
+
+        ofPath path;
+        path.setCurveResolution(RESOLUTION);
+        start = benchmark_clock::now();
+        for (int frame = 0; frame < FRAMES; frame++) {
+            particles.push_back(pointAt(next++));
+            particles.pop_front();
+            path.clear();
+            path.moveTo(particles.getLocation(0));
+            for (std::size_t i = 0; i < particles.size(); i++)
+                path.curveTo(particles.getLocation(i));
+            sink += path.getOutline().size();
+        }
+        double const pathMicroseconds = microsecondsSince(start) / FRAMES;
+
+        std::printf("%8d %16.1f %16.1f\n", length, syncMicroseconds, pathMicroseconds);
+        if (sink == 0)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * Stresses value_cell with three-field values whose fields are always written equal, so a
+ * torn copy shows up as unequal fields. First one writer publishes a rising count while the
+ * reader consumes and another thread reads getLatest(); neither may see a torn value or the
+ * count going backwards, and the last consume must see the final value. Then two writers
+ * increment through update() while a reader polls getLatest(); no increment may be lost.
+ * Exits non-zero on failure.
+ */
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "value_cell.h"
+
+using namespace ofxBenG;
+
+static int const COUNT = 1000000;
+static int const INCREMENTS = 200000;
+
+struct triple {
+    int a, b, c;
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char *what, int value) {
+    if (!condition) {
+        if (failures < 20)
+            std::printf("FAILED: %s (%d)\n", what, value);
+        failures++;
+    }
+}
+
+static bool isWhole(const triple &t) {
+    return t.a == t.b && t.b == t.c;
+}
+
+static void publishWhileConsuming() {
+    value_cell<triple> cell;
+    cell.seed(triple{0, 0, 0});
+    std::atomic<bool> isWriting = {true};
+    std::thread writer([&] {
+        for (int i = 1; i <= COUNT; i++)
+            cell.publish(triple{i, i, i});
+        isWriting.store(false);
+    });
+    std::thread latestReader([&] {
+        int last = 0;
+        while (isWriting.load()) {
+            triple const t = cell.getLatest();
+            check(isWhole(t), "getLatest() torn", t.a);
+            check(t.a >= last, "getLatest() went backwards", t.a);
+            last = t.a;
+        }
+    });
+
+    int last = 0;
+    triple t;
+    while (isWriting.load()) {
+        if (cell.consume(t)) {
+            check(isWhole(t), "consume() torn", t.a);
+            check(t.a > last, "consume() repeated or went backwards", t.a);
+            last = t.a;
+        }
+    }
+    writer.join();
+    latestReader.join();
+    if (cell.consume(t))
+        last = t.a;
+    check(last == COUNT, "last consume() missed the final value", last);
+    check(!cell.consume(t), "consume() returned a value twice", t.a);
+}
+
+static void incrementFromTwoWriters() {
+    value_cell<triple> cell;
+    cell.seed(triple{0, 0, 0});
+    std::atomic<int> writing = {2};
+    auto increment = [&] {
+        for (int i = 0; i < INCREMENTS; i++) {
+            cell.update([](triple &t) {
+                t.a++;
+                t.b++;
+                t.c++;
+                return true;
+            });
+        }
+        writing.fetch_sub(1);
+    };
+    std::thread first(increment);
+    std::thread second(increment);
+    while (writing.load() > 0) {
+        triple const t = cell.getLatest();
+        check(isWhole(t), "getLatest() torn during update()", t.a);
+    }
+    first.join();
+    second.join();
+    check(cell.getLatest().a == 2 * INCREMENTS, "update() lost increments", cell.getLatest().a);
+}
+
+int main() {
+    publishWhileConsuming();
+    incrementFromTwoWriters();
+    std::printf("value_cell: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
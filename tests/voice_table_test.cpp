@@ -0,0 +1,89 @@
+/*
+ * Stresses voice_table with one thread adding and three removing the same 48 voices as
+ * fast as they can, while a fourth walks the table the way the audio callback does. After
+ * every round each voice must sit in at most one slot, and removing every voice once must
+ * leave the table empty. Exits non-zero on failure.
+ */
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "voice_table.h"
+
+using namespace ofxBenG;
+
+static int const VOICES = 48;
+static int const REMOVERS = 3;
+static int const ROUNDS = 50;
+static int const OPERATIONS = 20000;
+
+int main() {
+    std::vector<int> voices(VOICES);
+    voice_table<int, 64> table;
+    int failures = 0;
+    long walked = 0;
+
+    /* The adder is the same thread every round, like the audio thread is. */
+    std::atomic<int> round = {-1};
+    std::atomic<int> addersDone = {0};
+    std::thread adder([&] {
+        std::mt19937 random(1);
+        for (int r = 0; r < ROUNDS; r++) {
+            while (round.load() < r)
+                std::this_thread::yield();
+            for (int i = 0; i < OPERATIONS; i++)
+                table.add(&voices[random() % VOICES]);
+            addersDone.fetch_add(1);
+        }
+    });
+
+    for (int r = 0; r < ROUNDS; r++) {
+        std::atomic<bool> isAdding = {true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < REMOVERS; t++) {
+            threads.emplace_back([&, t] {
+                std::mt19937 random(100 * r + t);
+                for (int i = 0; i < OPERATIONS; i++)
+                    table.remove(&voices[random() % VOICES]);
+            });
+        }
+        threads.emplace_back([&] {
+            while (isAdding.load()) {
+                std::size_t const end = table.getHighWater();
+                for (std::size_t i = 0; i < end; i++)
+                    walked += table.get(i) != nullptr;
+            }
+        });
+
+        round.store(r);
+        while (addersDone.load() <= r)
+            std::this_thread::yield();
+        isAdding.store(false);
+        for (auto &thread : threads)
+            thread.join();
+
+        for (int v = 0; v < VOICES; v++) {
+            int copies = 0;
+            for (std::size_t i = 0; i < table.getHighWater(); i++)
+                copies += table.get(i) == &voices[v];
+            if (copies > 1) {
+                printf("round %d: voice %d is in %d slots\n", r, v, copies);
+                failures++;
+            }
+        }
+        for (int v = 0; v < VOICES; v++)
+            table.remove(&voices[v]);
+        for (std::size_t i = 0; i < table.getHighWater(); i++) {
+            if (table.get(i) != nullptr) {
+                printf("round %d: slot %zu still holds a voice after removing all\n", r, i);
+                failures++;
+            }
+        }
+    }
+    adder.join();
+
+    printf("%d rounds of %d adds against %d removers, high water %zu, %ld occupied slots walked\n",
+           ROUNDS, OPERATIONS, REMOVERS, table.getHighWater(), walked);
+    return failures == 0 ? 0 : 1;
+}
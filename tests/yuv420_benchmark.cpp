@@ -0,0 +1,145 @@
+/*
+ * Throughput of yuv420's conversions on 1080p frames: packed RGBA, RGB and BGRA into I420
+ * when a frame is captured, and I420 back to RGB when a frame_header draws it. Each runs
+ * against a pixel-at-a-time version of the same fixed-point formulas, which must give the
+ * same bytes, to show what the row-wise arrays buy. Times are per frame and against the
+ * 16.7 ms a frame has at 60 fps. Build against openFrameworks with the addon's src on the
+ * include path and run; exits non-zero if the two versions disagree.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "yuv420.h"
+
+using namespace ofxBenG;
+
+typedef std::chrono::steady_clock benchmark_clock;
+
+static int const WIDTH = 1920;
+static int const HEIGHT = 1080;
+static int const FRAMES = 60;
+
+static double const FRAME_BUDGET_MS = 1000.0 / 60;
+
+static uint8_t clampByte(int32_t value) {
+    return (uint8_t) (value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static void scalarFromRgb(const uint8_t* rgb, std::size_t channels, bool isBgr, std::size_t width, std::size_t height,
+                          uint8_t* y, uint8_t* u, uint8_t* v) {
+    std::size_t const redOffset = isBgr ? 2 : 0;
+    std::size_t const blueOffset = isBgr ? 0 : 2;
+    for (std::size_t row = 0; row < height; row += 2) {
+        for (std::size_t x = 0; x < width; x += 2) {
+            int32_t red = 0, green = 0, blue = 0;
+            for (std::size_t dy = 0; dy < 2; dy++) {
+                for (std::size_t dx = 0; dx < 2; dx++) {
+                    const uint8_t* pixel = rgb + ((row + dy) * width + x + dx) * channels;
+                    int32_t const r = pixel[redOffset], g = pixel[1], b = pixel[blueOffset];
+                    y[(row + dy) * width + x + dx] = (uint8_t) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                    red += r;
+                    green += g;
+                    blue += b;
+                }
+            }
+            red = (red + 2) >> 2;
+            green = (green + 2) >> 2;
+            blue = (blue + 2) >> 2;
+            std::size_t const chroma = (row / 2) * (width / 2) + x / 2;
+            u[chroma] = (uint8_t) (((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+            v[chroma] = (uint8_t) (((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+        }
+    }
+}
+
+static void scalarToRgb(const uint8_t* y, const uint8_t* u, const uint8_t* v, std::size_t width, std::size_t height, uint8_t* rgb) {
+    for (std::size_t row = 0; row < height; row++) {
+        for (std::size_t x = 0; x < width; x++) {
+            std::size_t const chroma = (row / 2) * (width / 2) + x / 2;
+            int32_t const c = 298 * (y[row * width + x] - 16);
+            int32_t const d = u[chroma] - 128;
+            int32_t const e = v[chroma] - 128;
+            uint8_t* out = rgb + (row * width + x) * 3;
+            out[0] = clampByte((c + 409 * e + 128) >> 8);
+            out[1] = clampByte((c - 100 * d - 208 * e + 128) >> 8);
+            out[2] = clampByte((c + 516 * d + 128) >> 8);
+        }
+    }
+}
+
+template <typename Convert>
+static double timeFrames(Convert convert) {
+    convert();
+    benchmark_clock::time_point const start = benchmark_clock::now();
+    for (int i = 0; i < FRAMES; i++) {
+        convert();
+    }
+    return std::chrono::duration<double, std::milli>(benchmark_clock::now() - start).count() / FRAMES;
+}
+
+static void printRow(const char* name, double milliseconds) {
+    double const megapixels = WIDTH * HEIGHT / 1000000.0;
+    std::printf("%-24s %10.2f %12.0f %10.0f%%\n", name, milliseconds, megapixels / (milliseconds / 1000), 100 * milliseconds / FRAME_BUDGET_MS);
+}
+
+int main() {
+    std::size_t const pixels = (std::size_t) WIDTH * HEIGHT;
+    std::size_t const planeBytes = pixels + 2 * (pixels / 4);
+    std::vector<uint8_t> packed(pixels * 4);
+    for (std::size_t i = 0; i < packed.size(); i++) {
+        packed[i] = (uint8_t) (i * 7 + (i >> 11) * 13);
+    }
+    std::vector<uint8_t> planes(planeBytes), scalarPlanes(planeBytes);
+    std::vector<uint8_t> rgb(pixels * 3), scalarRgb(pixels * 3);
+    uint8_t* y = planes.data();
+    uint8_t* u = y + pixels;
+    uint8_t* v = u + pixels / 4;
+    uint8_t* scalarY = scalarPlanes.data();
+    uint8_t* scalarU = scalarY + pixels;
+    uint8_t* scalarV = scalarU + pixels / 4;
+
+    std::printf("%dx%d, %d frames each\n", WIDTH, HEIGHT, FRAMES);
+    std::printf("%-24s %10s %12s %11s\n", "", "ms/frame", "Mpixel/s", "of 60 fps");
+
+    int failures = 0;
+    struct packing {
+        const char* name;
+        std::size_t channels;
+        bool isBgr;
+    };
+    packing const packings[] = {{"RGBA to I420", 4, false}, {"BGRA to I420", 4, true}, {"RGB to I420", 3, false}};
+    for (const packing& p : packings) {
+        printRow(p.name, timeFrames([&]() {
+            yuv420::fromRgb(packed.data(), p.channels, p.isBgr, WIDTH, HEIGHT, y, u, v);
+        }));
+        printRow("  pixel at a time", timeFrames([&]() {
+            scalarFromRgb(packed.data(), p.channels, p.isBgr, WIDTH, HEIGHT, scalarY, scalarU, scalarV);
+        }));
+        if (planes != scalarPlanes) {
+            std::printf("FAIL: %s differs from the pixel-at-a-time conversion\n", p.name);
+            failures++;
+        }
+    }
+
+    yuv420::fromRgb(packed.data(), 4, false, WIDTH, HEIGHT, y, u, v);
+    printRow("I420 to RGB", timeFrames([&]() {
+        yuv420::toRgb(y, u, v, WIDTH, HEIGHT, rgb.data());
+    }));
+    printRow("  pixel at a time", timeFrames([&]() {
+        scalarToRgb(y, u, v, WIDTH, HEIGHT, scalarRgb.data());
+    }));
+    if (rgb != scalarRgb) {
+        std::printf("FAIL: I420 to RGB differs from the pixel-at-a-time conversion\n");
+        failures++;
+    }
+
+    ofPixels frame, stored, shown;
+    frame.allocate(WIDTH, HEIGHT, OF_PIXELS_RGBA);
+    std::memcpy(frame.getData(), packed.data(), packed.size());
+    printRow("capture and draw", timeFrames([&]() {
+        yuv420::store(frame, stored);
+        yuv420::toRgb(stored, shown);
+    }));
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+/*
+ * Round trip through yuv420 on flat 2x2 blocks, which 4:2:0 subsampling keeps exactly, so
+ * any error left is the fixed-point conversion's. Build against openFrameworks with the
+ * addon's src on the include path and run; exits non-zero on failure.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "yuv420.h"
+
+using namespace ofxBenG;
+
+static int const MAX_ERROR = 3;
+
+static int roundTripError(int red, int green, int blue, bool isBgr) {
+    std::size_t const width = 2, height = 2, channels = 4;
+    uint8_t packed[width * height * channels];
+    for (std::size_t i = 0; i < width * height; i++) {
+        packed[i * channels + 0] = isBgr ? blue : red;
+        packed[i * channels + 1] = green;
+        packed[i * channels + 2] = isBgr ? red : blue;
+        packed[i * channels + 3] = 255;
+    }
+    uint8_t y[width * height], u[1], v[1];
+    yuv420::fromRgb(packed, channels, isBgr, width, height, y, u, v);
+    uint8_t rgb[width * height * 3];
+    yuv420::toRgb(y, u, v, width, height, rgb);
+
+    int worst = 0;
+    int const expected[3] = {red, green, blue};
+    for (std::size_t i = 0; i < width * height; i++) {
+        for (int c = 0; c < 3; c++) {
+            worst = std::max(worst, std::abs(rgb[i * 3 + c] - expected[c]));
+        }
+    }
+    return worst;
+}
+
+int main() {
+    int worst = 0;
+    for (int red = 0; red < 256; red += 3) {
+        for (int green = 0; green < 256; green += 3) {
+            for (int blue = 0; blue < 256; blue += 3) {
+                worst = std::max(worst, roundTripError(red, green, blue, false));
+                worst = std::max(worst, roundTripError(red, green, blue, true));
+            }
+        }
+    }
+    std::printf("yuv420 round trip: worst channel error %d, allowed %d\n", worst, MAX_ERROR);
+    return worst <= MAX_ERROR ? 0 : 1;
+}